@@ -0,0 +1,157 @@
+/*
+Общее для драйверов lab7: профиль глубин веток, разбор параметров
+командной строки, привязка потоков к ядрам и пул потоков, раздающий
+повторениям собственные генераторы.
+ */
+
+#ifndef BENCH_RUNNER_H
+#define BENCH_RUNNER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <ctime>
+#include <exception>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// Профиль глубин веток, накапливаемый потоково: число листьев на каждой
+// глубине и суммы для моментов. Память - O(высоты), сколько бы деревьев
+// и повторений в него ни попало
+struct DepthProfile {
+    std::vector<long long> counts; // counts[d] - число листьев на глубине d
+    long long leaves = 0;
+    double sum = 0;
+    double sumSquares = 0;
+
+    void add(int depth, long long count = 1) {
+        if (depth >= static_cast<int>(counts.size())) counts.resize(depth + 1, 0);
+        counts[depth] += count;
+        leaves += count;
+        sum += static_cast<double>(depth) * count;
+        sumSquares += static_cast<double>(depth) * depth * count;
+    }
+
+    void merge(const DepthProfile& other) {
+        for (size_t d = 0; d < other.counts.size(); ++d) {
+            if (other.counts[d]) add(d, other.counts[d]);
+        }
+    }
+
+    double mean() const { return leaves ? sum / leaves : 0.0; }
+    double stddev() const { return leaves ? std::sqrt(std::max(0.0, sumSquares / leaves - mean() * mean())) : 0.0; }
+    int maxDepth() const { return leaves ? static_cast<int>(counts.size()) - 1 : 0; }
+
+    int minDepth() const {
+        for (size_t d = 0; d < counts.size(); ++d) {
+            if (counts[d]) return d;
+        }
+        return 0;
+    }
+
+    // Глубина листа с номером floor(q * leaves) в порядке возрастания глубин
+    int percentile(double q) const {
+        long long target = static_cast<long long>(q * leaves);
+        long long seen = 0;
+        for (size_t d = 0; d < counts.size(); ++d) {
+            seen += counts[d];
+            if (seen > target) return d;
+        }
+        return maxDepth();
+    }
+};
+
+// Параметры запуска драйвера: --threads=N (по умолчанию все ядра),
+// --pin (привязка потоков к ядрам) и --seed=S (зерно генераторов)
+struct RunOptions {
+    int threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    bool pin = false;
+    unsigned seed = static_cast<unsigned>(std::time(nullptr));
+};
+
+inline RunOptions parseOptions(int argc, char** argv) {
+    RunOptions options;
+    for (int a = 1; a < argc; ++a) {
+        std::string arg = argv[a];
+        if (arg.rfind("--threads=", 0) == 0) {
+            options.threads = std::max(1, std::stoi(arg.substr(10)));
+        } else if (arg == "--pin") {
+            options.pin = true;
+        } else if (arg.rfind("--seed=", 0) == 0) {
+            options.seed = static_cast<unsigned>(std::stoul(arg.substr(7)));
+        } else {
+            throw std::invalid_argument("Unknown option " + arg + " (expected --threads=N, --pin, --seed=S)");
+        }
+    }
+    return options;
+}
+
+// Привязка текущего потока к index-му из доступных процессу ядер:
+// повторение не мигрирует посреди замера и не делит ядро с соседом
+inline void pinCurrentThread(int index) {
+#ifdef __linux__
+    cpu_set_t allowed;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return;
+    int target = index % std::max(1, CPU_COUNT(&allowed));
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &allowed) && target-- == 0) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu, &set);
+            pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+            return;
+        }
+    }
+#else
+    (void)index;
+#endif
+}
+
+// Выполнение повторений серии на пуле потоков. Потоки разбирают номера
+// повторений из общего счётчика; каждое повторение получает собственный
+// генератор, зависящий только от зерна, серии и номера, и пишет результаты
+// в свои ячейки - итог не зависит ни от числа потоков, ни от порядка
+template <typename Body>
+void runRepetitions(int repetitions, int series, const RunOptions& options, Body body) {
+    std::atomic<int> next(0);
+    std::exception_ptr failure;
+    std::mutex failureMutex;
+
+    auto worker = [&](int index) {
+        if (options.pin) pinCurrentThread(index);
+        for (int rep = next++; rep < repetitions; rep = next++) {
+            std::seed_seq seq{options.seed, static_cast<unsigned>(series), static_cast<unsigned>(rep)};
+            std::mt19937 rng(seq);
+            try {
+                body(rep, rng);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(failureMutex);
+                if (!failure) failure = std::current_exception();
+            }
+        }
+    };
+
+    int threads = std::min(options.threads, repetitions);
+    if (threads <= 1) {
+        worker(0);
+    } else {
+        std::vector<std::thread> pool;
+        for (int t = 0; t < threads; ++t) {
+            pool.emplace_back(worker, t);
+        }
+        for (std::thread& th : pool) {
+            th.join();
+        }
+    }
+    if (failure) std::rethrow_exception(failure);
+}
+
+#endif
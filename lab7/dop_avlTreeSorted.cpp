@@ -7,6 +7,14 @@
 #include <climits>
 #include <fstream>
 #include <map>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <exception>
+#include <string>
+#include <ctime>
+#include <stdexcept>
+#include "benchRunner.h"
 
 using namespace std;
 using namespace std::chrono;
@@ -21,10 +29,24 @@ struct AVLNode {
     AVLNode(int k) : key(k), left(nullptr), right(nullptr), height(1) {}
 };
 
+// Ячейка блока узлов freeze(): выравнивание по размеру узла (32 байта),
+// чтобы ни один узел не пересекал границу строки кэша
+struct alignas(32) FrozenSlot {
+    AVLNode node;
+    
+    FrozenSlot(const AVLNode& source) : node(source) {}
+};
+
 // AVL-дерево для отсортированных данных
 class SortedAVLTree {
 private:
     AVLNode* root;
+    // Кэш правого хребта (палец): путь от корня до максимума.
+    // Сбрасывается любой операцией, кроме добавления в конец
+    vector<AVLNode*> spine;
+    bool spineValid;
+    // Блок узлов, перенесённых freeze(); узлы из него по одному не освобождаются
+    vector<FrozenSlot> frozenNodes;
     
     // Получение высоты узла
     int getHeight(AVLNode* node) const {
@@ -103,14 +125,88 @@ private:
         return node;
     }
     
-    // Вставка узла в отсортированном порядке (всегда вправо)
-    AVLNode* insertSorted(AVLNode* node, int key) {
-        if (!node) return new AVLNode(key);
-        
-        // Всегда вставляем в правое поддерево для сохранения порядка
-        node->right = insertSorted(node->right, key);
+    // Восстановление кэша правого хребта
+    void ensureSpine() {
+        if (spineValid) return;
+        spine.clear();
+        for (AVLNode* node = root; node; node = node->right) {
+            spine.push_back(node);
+        }
+        spineValid = true;
+    }
+    
+    // Балансировка хребта снизу вверх, начиная с узла spine[i].
+    // Останавливается, как только высота поддерева перестала меняться:
+    // выше неё ничего не изменилось, поэтому добавление в конец в среднем O(1)
+    void rebalanceSpine(int i) {
+        for (; i >= 0; --i) {
+            AVLNode* node = spine[i];
+            int oldHeight = node->height;
+            AVLNode* top = balance(node);
+            
+            if (top != node) {
+                // После поворота перестраиваем хвост хребта от нового корня поддерева
+                if (i == 0) root = top; else spine[i - 1]->right = top;
+                spine.resize(i);
+                for (AVLNode* n = top; n; n = n->right) {
+                    spine.push_back(n);
+                }
+            }
+            
+            if (top->height == oldHeight) return;
+        }
+    }
+    
+    // Соединение дерева left, узла middle и более высокого дерева right
+    // (все ключи left < middle < все ключи right)
+    AVLNode* joinShortLeft(AVLNode* left, AVLNode* middle, AVLNode* right) {
+        if (getHeight(right) <= getHeight(left) + 1) {
+            middle->left = left;
+            middle->right = right;
+            updateHeight(middle);
+            return middle;
+        }
         
-        return balance(node);
+        right->left = joinShortLeft(left, middle, right->left);
+        return balance(right);
+    }
+    
+    // Проверка, что ключи идут строго по возрастанию после текущего максимума
+    void checkAppendOrder(const vector<int>& keys) {
+        ensureSpine();
+        for (size_t i = 0; i < keys.size(); ++i) {
+            if ((i == 0 && !spine.empty() && keys[i] <= spine.back()->key) ||
+                (i > 0 && keys[i] <= keys[i - 1])) {
+                throw invalid_argument("SortedAVLTree: appended keys must be strictly greater than the current maximum");
+            }
+        }
+    }
+    
+    bool isFrozen(const AVLNode* node) const {
+        return !frozenNodes.empty() && node >= &frozenNodes.front().node && node <= &frozenNodes.back().node;
+    }
+    
+    // Освобождение узла: узел из блока остаётся в нём до очистки дерева
+    void release(AVLNode* node) {
+        if (!isFrozen(node)) delete node;
+    }
+    
+    // Раскладка ван Эмде Боаса верхних levels уровней поддерева node:
+    // сначала рекурсивно верхняя половина уровней, затем по очереди каждое
+    // поддерево под ней. Корни поддеревьев ниже levels уровней - в frontier
+    void vanEmdeBoasOrder(AVLNode* node, int levels, vector<AVLNode*>& order, vector<AVLNode*>& frontier) {
+        if (levels == 1) {
+            order.push_back(node);
+            if (node->left) frontier.push_back(node->left);
+            if (node->right) frontier.push_back(node->right);
+            return;
+        }
+        int topLevels = levels / 2;
+        vector<AVLNode*> middle;
+        vanEmdeBoasOrder(node, topLevels, order, middle);
+        for (AVLNode* subtree : middle) {
+            vanEmdeBoasOrder(subtree, levels - topLevels, order, frontier);
+        }
     }
     
     // Вставка узла (обычная, для тестирования)
@@ -155,7 +251,7 @@ private:
                     *node = *temp;
                 }
                 
-                delete temp;
+                release(temp);
             } else {
                 AVLNode* temp = findMin(node->right);
                 node->key = temp->key;
@@ -181,35 +277,81 @@ private:
         return 1 + max(maxDepth(node->left), maxDepth(node->right));
     }
     
-    // Сбор глубин всех веток
-    void collectBranchDepths(AVLNode* node, int currentDepth, vector<int>& depths) const {
-        if (!node) return;
+public:
+    SortedAVLTree() : root(nullptr), spineValid(false) {}
+    
+    // Вставка элемента в конец (ключ больше всех существующих).
+    // Новый узел подвешивается к последнему узлу кэшированного хребта,
+    // балансировка идёт снизу вверх - амортизированно O(1)
+    void insertSorted(int key) {
+        ensureSpine();
+        if (!spine.empty() && key <= spine.back()->key) {
+            throw invalid_argument("SortedAVLTree: appended keys must be strictly greater than the current maximum");
+        }
         
-        if (!node->left && !node->right) {
-            depths.push_back(currentDepth + 1);
+        AVLNode* node = new AVLNode(key);
+        if (spine.empty()) {
+            root = node;
+            spine.push_back(node);
             return;
         }
         
-        collectBranchDepths(node->left, currentDepth + 1, depths);
-        collectBranchDepths(node->right, currentDepth + 1, depths);
+        spine.back()->right = node;
+        spine.push_back(node);
+        rebalanceSpine(static_cast<int>(spine.size()) - 2);
     }
     
-public:
-    SortedAVLTree() : root(nullptr) {}
-    
-    // Вставка элемента в отсортированном порядке
-    void insertSorted(int key) {
-        root = insertSorted(root, key);
+    // Пакетное добавление возрастающей серии ключей: из серии строится
+    // сбалансированное поддерево и прививается к правому хребту на уровне
+    // своей высоты - O(k + log n) вместо k отдельных вставок
+    void appendRange(const vector<int>& keys) {
+        if (keys.empty()) return;
+        checkAppendOrder(keys);
+        
+        if (!root) {
+            root = buildBalancedFromSortedArray(keys, 0, keys.size() - 1);
+            spineValid = false;
+            return;
+        }
+        
+        // Первый ключ серии становится узлом-соединителем
+        AVLNode* middle = new AVLNode(keys[0]);
+        AVLNode* graft = buildBalancedFromSortedArray(keys, 1, keys.size() - 1);
+        int graftHeight = getHeight(graft);
+        
+        // Самый верхний узел хребта с высотой не больше высоты привоя (ищем снизу)
+        int j = spine.size();
+        while (j > 0 && spine[j - 1]->height <= graftHeight) --j;
+        
+        if (j == 0 && root->height < graftHeight - 1) {
+            // Серия намного выше дерева - спускаемся по левому краю привоя
+            root = joinShortLeft(root, middle, graft);
+            spineValid = false;
+            return;
+        }
+        
+        middle->left = j < static_cast<int>(spine.size()) ? spine[j] : nullptr;
+        middle->right = graft;
+        updateHeight(middle);
+        
+        if (j == 0) root = middle; else spine[j - 1]->right = middle;
+        spine.resize(j);
+        for (AVLNode* node = middle; node; node = node->right) {
+            spine.push_back(node);
+        }
+        rebalanceSpine(j - 1);
     }
     
     // Вставка элемента (обычная)
     void insert(int key) {
         root = insert(root, key);
+        spineValid = false;
     }
     
     // Удаление элемента
     void remove(int key) {
         root = remove(root, key);
+        spineValid = false;
     }
     
     // Поиск элемента
@@ -222,11 +364,59 @@ public:
         return maxDepth(root);
     }
     
-    // Получение глубин всех веток
-    vector<int> getAllBranchDepths() const {
-        vector<int> depths;
-        collectBranchDepths(root, 0, depths);
-        return depths;
+    // Добавление глубин всех веток в профиль. Обход без рекурсии: в стеке
+    // только отложенные правые поддеревья, по одному на уровень - O(высоты)
+    void profileDepths(DepthProfile& profile) const {
+        vector<pair<const AVLNode*, int>> pending;
+        const AVLNode* node = root;
+        int depth = 1;
+        while (node) {
+            bool hasLeft = node->left;
+            bool hasRight = node->right;
+            if (hasLeft || hasRight) {
+                if (hasLeft && hasRight) pending.push_back({node->right, depth + 1});
+                node = hasLeft ? node->left : node->right;
+                ++depth;
+                continue;
+            }
+    
+            profile.add(depth);
+            if (pending.empty()) break;
+            node = pending.back().first;
+            depth = pending.back().second;
+            pending.pop_back();
+        }
+    }
+    
+    // Перенос всех узлов в один непрерывный блок в раскладке ван Эмде Боаса:
+    // каждое поддерево из ~sqrt(h) верхних или нижних уровней лежит подряд,
+    // и путь от корня к листу задевает O(log_B n) строк кэша при любом их
+    // размере B. Поиск не меняется. Дерево остаётся изменяемым, но новые
+    // узлы выделяются отдельно - после серии изменений freeze() повторяют
+    void freeze() {
+        if (!root) return;
+        vector<AVLNode*> order, frontier;
+        vanEmdeBoasOrder(root, maxDepth(root), order, frontier);
+        
+        // Копии узлов; левая ссылка старого узла временно указывает на его копию
+        vector<FrozenSlot> block;
+        block.reserve(order.size());
+        for (AVLNode* node : order) {
+            block.emplace_back(*node);
+            node->left = &block.back().node;
+        }
+        for (FrozenSlot& slot : block) {
+            if (slot.node.left) slot.node.left = slot.node.left->left;
+            if (slot.node.right) slot.node.right = slot.node.right->left;
+        }
+        
+        AVLNode* newRoot = root->left;
+        for (AVLNode* node : order) {
+            release(node);
+        }
+        frozenNodes.swap(block);
+        root = newRoot;
+        spineValid = false;
     }
     
     // Очистка дерева
@@ -234,6 +424,7 @@ public:
         while (root) {
             remove(root->key);
         }
+        vector<FrozenSlot>().swap(frozenNodes);
     }
     
     // Построение дерева из отсортированного массива (оптимальный метод)
@@ -241,6 +432,7 @@ public:
         if (end == -1) end = sortedArray.size() - 1;
         clear();
         root = buildBalancedFromSortedArray(sortedArray, start, end);
+        spineValid = false;
     }
     
 private:
@@ -260,23 +452,25 @@ private:
 };
 
 // Функция для тестирования AVL-дерева с отсортированными данными
-void testSortedAVLTree() {
+void testSortedAVLTree(const RunOptions& options) {
     const int REPETITIONS = 50;
     const int OPERATIONS = 1000;
     
     for (int i = 10; i <= 18; ++i) {
         const size_t N = 1 << i; // 2^i
         
-        vector<double> maxDepths;
-        vector<double> buildTimes;
-        vector<double> insertTimes;
-        vector<double> deleteTimes;
-        vector<double> searchTimes;
-        vector<int> allBranchDepths;
+        vector<double> maxDepths(REPETITIONS);
+        vector<double> buildTimes(REPETITIONS);
+        vector<double> insertTimes(REPETITIONS);
+        vector<double> appendRangeTimes(REPETITIONS);
+        vector<double> deleteTimes(REPETITIONS);
+        vector<double> searchTimes(REPETITIONS);
+        DepthProfile branchProfile;
+        vector<DepthProfile> repProfiles(REPETITIONS);
         
         //cout << "Testing Sorted AVL Tree with N = 2^" << i << " = " << N << "..." << endl;
         
-        for (int rep = 0; rep < REPETITIONS; ++rep) {
+        runRepetitions(REPETITIONS, i, options, [&](int rep, mt19937& rng) {
             SortedAVLTree tree;
             
             // 1. Генерация отсортированных значений
@@ -289,10 +483,10 @@ void testSortedAVLTree() {
             auto start = high_resolution_clock::now();
             tree.buildFromSortedArray(elements);
             auto end = high_resolution_clock::now();
-            buildTimes.push_back(duration_cast<microseconds>(end - start).count() / 1000.0);
+            buildTimes[rep] = duration_cast<microseconds>(end - start).count() / 1000.0;
             
             // 3. Замер максимальной глубины
-            maxDepths.push_back(tree.getMaxDepth());
+            maxDepths[rep] = tree.getMaxDepth();
             
             // 4. 1000 операций вставки в конец и замер времени
             start = high_resolution_clock::now();
@@ -300,58 +494,74 @@ void testSortedAVLTree() {
                 tree.insertSorted(N + j); // Вставляем элементы больше всех существующих
             }
             end = high_resolution_clock::now();
-            insertTimes.push_back(duration_cast<microseconds>(end - start).count() / 1000.0);
+            insertTimes[rep] = duration_cast<microseconds>(end - start).count() / 1000.0;
+            
+            // 4.1. Пакетное добавление серии из 1000 следующих ключей
+            vector<int> run(OPERATIONS);
+            for (int j = 0; j < OPERATIONS; ++j) {
+                run[j] = N + OPERATIONS + j;
+            }
+            start = high_resolution_clock::now();
+            tree.appendRange(run);
+            end = high_resolution_clock::now();
+            appendRangeTimes[rep] = duration_cast<microseconds>(end - start).count() / 1000.0;
             
             // 5. 1000 операций удаления и замер времени
             start = high_resolution_clock::now();
             for (int j = 0; j < OPERATIONS; ++j) {
                 int elem = elements.empty() ? N + j : 
-                          elements[rand() % elements.size()];
+                          elements[rng() % elements.size()];
                 tree.remove(elem);
                 if (!elements.empty()) {
                     elements.erase(remove(elements.begin(), elements.end(), elem), elements.end());
                 }
             }
             end = high_resolution_clock::now();
-            deleteTimes.push_back(duration_cast<microseconds>(end - start).count() / 1000.0);
+            deleteTimes[rep] = duration_cast<microseconds>(end - start).count() / 1000.0;
             
             // 6. 1000 операций поиска и замер времени
             start = high_resolution_clock::now();
             for (int j = 0; j < OPERATIONS; ++j) {
                 int elem = elements.empty() ? N + j : 
-                          elements[rand() % elements.size()];
+                          elements[rng() % elements.size()];
                 tree.contains(elem);
             }
             end = high_resolution_clock::now();
-            searchTimes.push_back(duration_cast<microseconds>(end - start).count() / 1000.0);
+            searchTimes[rep] = duration_cast<microseconds>(end - start).count() / 1000.0;
             
-            // 7. Сбор глубин всех веток
-            vector<int> depths = tree.getAllBranchDepths();
-            allBranchDepths.insert(allBranchDepths.end(), depths.begin(), depths.end());
+            // 7. Профиль глубин всех веток
+            tree.profileDepths(repProfiles[rep]);
+        });
+        
+        // Профили повторений сливаются по порядку номеров
+        for (const DepthProfile& profile : repProfiles) {
+            branchProfile.merge(profile);
         }
         
         // Вычисление статистики
         double avgMaxDepth = accumulate(maxDepths.begin(), maxDepths.end(), 0.0) / maxDepths.size();
         double avgBuildTime = accumulate(buildTimes.begin(), buildTimes.end(), 0.0) / buildTimes.size();
         double avgInsertTime = accumulate(insertTimes.begin(), insertTimes.end(), 0.0) / insertTimes.size();
+        double avgAppendRangeTime = accumulate(appendRangeTimes.begin(), appendRangeTimes.end(), 0.0) / appendRangeTimes.size();
         double avgDeleteTime = accumulate(deleteTimes.begin(), deleteTimes.end(), 0.0) / deleteTimes.size();
         double avgSearchTime = accumulate(searchTimes.begin(), searchTimes.end(), 0.0) / searchTimes.size();
         
-        double avgBranchDepth = accumulate(allBranchDepths.begin(), allBranchDepths.end(), 0.0) / allBranchDepths.size();
-        int minBranchDepth = *min_element(allBranchDepths.begin(), allBranchDepths.end());
-        int maxBranchDepth = *max_element(allBranchDepths.begin(), allBranchDepths.end());
+        double avgBranchDepth = branchProfile.mean();
+        int minBranchDepth = branchProfile.minDepth();
+        int maxBranchDepth = branchProfile.maxDepth();
         
         // Вывод результатов
         /*cout << "Results for sorted N = " << N << ":" << endl;
         cout << "  Average build time: " << avgBuildTime << " ms" << endl;
         cout << "  Average max depth: " << avgMaxDepth << " (expected ~" << log2(N) << ")" << endl;
         cout << "  Average insert time for " << OPERATIONS << " ops: " << avgInsertTime << " ms" << endl;
+        cout << "  Average appendRange time for " << OPERATIONS << " keys: " << avgAppendRangeTime << " ms" << endl;
         cout << "  Average delete time for " << OPERATIONS << " ops: " << avgDeleteTime << " ms" << endl;
         cout << "  Average search time for " << OPERATIONS << " ops: " << avgSearchTime << " ms" << endl;
         cout << "  Branch depths - avg: " << avgBranchDepth << ", min: " << minBranchDepth 
-             << ", max: " << maxBranchDepth << endl;
+             << ", max: " << maxBranchDepth << ", stddev: " << branchProfile.stddev() << endl;
         cout << endl;*/
-        cout << N << "," << avgInsertTime << "," << avgDeleteTime << "," << avgSearchTime << "," << avgMaxDepth << endl;
+        cout << N << "," << avgInsertTime << "," << avgDeleteTime << "," << avgSearchTime << "," << avgMaxDepth << "," << avgAppendRangeTime << endl;
         
 
         if (i == 18) {
@@ -363,17 +573,17 @@ void testSortedAVLTree() {
             }
             
             // Гистограмма высот веток
-            vector<int> branchDepths = allBranchDepths;
-            if (!branchDepths.empty()) {
-                int min_depth = *min_element(branchDepths.begin(), branchDepths.end());
-                int max_depth = *max_element(branchDepths.begin(), branchDepths.end());
+            if (branchProfile.leaves) {
+                int min_depth = branchProfile.minDepth();
+                int max_depth = branchProfile.maxDepth();
                 int range = max_depth - min_depth;
                 int bin_size = max(1, range / 15);
                 
-                map<int, int> branchDepthHist;
-                for (int depth : branchDepths) {
+                map<int, long long> branchDepthHist;
+                for (int depth = min_depth; depth <= max_depth; ++depth) {
+                    if (!branchProfile.counts[depth]) continue;
                     int bin = (depth - min_depth) / bin_size * bin_size + min_depth;
-                    branchDepthHist[bin]++;
+                    branchDepthHist[bin] += branchProfile.counts[depth];
                 }
                 
                 ofstream branchDepthFile("sorted_avl_branch_depths.csv");
@@ -388,8 +598,72 @@ void testSortedAVLTree() {
     }
 }
 
-int main() {
-    srand(time(nullptr)); // Инициализация генератора случайных чисел
-    testSortedAVLTree();
+// Поиск в дереве из buildFromSortedArray до и после freeze() на 2^16..2^24
+// ключах. Ключи чётные, запросы случайные - в дереве примерно половина
+void testFrozenLayout(const RunOptions& options) {
+    const int QUERIES = 1000000;
+    mt19937 rng(options.seed);
+    
+    ofstream csv("sorted_avl_frozen.csv");
+    csv << "N,Build_ms,Freeze_ms,Search_ns,Frozen_Search_ns\n";
+    
+    auto measureSearch = [](const SortedAVLTree& tree, const vector<int>& queries, size_t& found) {
+        auto start = high_resolution_clock::now();
+        size_t hits = 0;
+        for (int key : queries) {
+            hits += tree.contains(key);
+        }
+        auto end = high_resolution_clock::now();
+        found = hits;
+        return duration_cast<nanoseconds>(end - start).count() / static_cast<double>(queries.size());
+    };
+    
+    for (int i = 16; i <= 24; i += 2) {
+        const size_t N = 1 << i; // 2^i
+        vector<int> elements(N);
+        for (size_t j = 0; j < N; ++j) {
+            elements[j] = static_cast<int>(2 * j);
+        }
+        vector<int> queries(QUERIES);
+        for (int& key : queries) {
+            key = static_cast<int>(rng() % (2 * N));
+        }
+        
+        SortedAVLTree tree;
+        auto start = high_resolution_clock::now();
+        tree.buildFromSortedArray(elements);
+        auto end = high_resolution_clock::now();
+        double buildTime = duration_cast<microseconds>(end - start).count() / 1000.0;
+        
+        size_t found, frozenFound;
+        double searchTime = measureSearch(tree, queries, found);
+        
+        start = high_resolution_clock::now();
+        tree.freeze();
+        end = high_resolution_clock::now();
+        double freezeTime = duration_cast<microseconds>(end - start).count() / 1000.0;
+        
+        double frozenSearchTime = measureSearch(tree, queries, frozenFound);
+        if (found != frozenFound) {
+            throw logic_error("Frozen tree disagrees with the original one");
+        }
+        
+        cout << "Frozen layout, N = 2^" << i << ": search " << searchTime << " ns -> " << frozenSearchTime
+             << " ns after freeze (" << freezeTime << " ms)" << endl;
+        csv << N << "," << buildTime << "," << freezeTime << "," << searchTime << "," << frozenSearchTime << "\n";
+    }
+    
+    cout << "Frozen layout data saved to sorted_avl_frozen.csv" << endl;
+}
+
+int main(int argc, char** argv) {
+    try {
+        RunOptions options = parseOptions(argc, argv);
+        testSortedAVLTree(options);
+        testFrozenLayout(options);
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
     return 0;
 }
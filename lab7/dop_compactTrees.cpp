@@ -0,0 +1,1178 @@
+/*
+12) Компактное представление узлов: узлы лежат подряд в пуле и адресуются
+    32-битными индексами, высота AVL-узла и цвет RB-узла упакованы в свободные
+    старшие биты ссылок. Сравнение скорости поиска и удаления с деревьями на
+    указателях при N = 2^18 и больше. Деревья на указателях - копии классов из
+    avlTree.cpp, dop_RBTree. и randomisedBST.cpp с теми же узлами и теми же
+    алгоритмами вставки и удаления (без остальных операций).
+ */
+
+// реализация компактных деревьев
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <climits>
+#include <fstream>
+#include <cstdint>
+#include <stdexcept>
+
+using namespace std;
+using namespace std::chrono;
+
+// ---------------- Деревья на указателях (копии avlTree.cpp, dop_RBTree., randomisedBST.cpp) ----------------
+
+// Узел AVL-дерева
+struct AVLNode {
+    int key;
+    AVLNode* left;
+    AVLNode* right;
+    int height;
+
+    AVLNode(int k) : key(k), left(nullptr), right(nullptr), height(1) {}
+};
+
+// AVL-дерево на указателях (вставка, удаление и поиск)
+class AVLTree {
+private:
+    AVLNode* root;
+
+    int getHeight(AVLNode* node) const {
+        return node ? node->height : 0;
+    }
+
+    void updateHeight(AVLNode* node) {
+        node->height = 1 + max(getHeight(node->left), getHeight(node->right));
+    }
+
+    AVLNode* rotateRight(AVLNode* y) {
+        AVLNode* x = y->left;
+        y->left = x->right;
+        x->right = y;
+        updateHeight(y);
+        updateHeight(x);
+        return x;
+    }
+
+    AVLNode* rotateLeft(AVLNode* x) {
+        AVLNode* y = x->right;
+        x->right = y->left;
+        y->left = x;
+        updateHeight(x);
+        updateHeight(y);
+        return y;
+    }
+
+    AVLNode* balance(AVLNode* node) {
+        updateHeight(node);
+        int balanceFactor = getHeight(node->left) - getHeight(node->right);
+        if (balanceFactor > 1) {
+            if (getHeight(node->left->left) < getHeight(node->left->right)) {
+                node->left = rotateLeft(node->left);
+            }
+            return rotateRight(node);
+        }
+        if (balanceFactor < -1) {
+            if (getHeight(node->right->right) < getHeight(node->right->left)) {
+                node->right = rotateRight(node->right);
+            }
+            return rotateLeft(node);
+        }
+        return node;
+    }
+
+    AVLNode* insert(AVLNode* node, int key) {
+        if (!node) return new AVLNode(key);
+        if (key < node->key) {
+            node->left = insert(node->left, key);
+        } else if (key > node->key) {
+            node->right = insert(node->right, key);
+        } else {
+            return node;
+        }
+        return balance(node);
+    }
+
+    AVLNode* findMin(AVLNode* node) const {
+        while (node && node->left) {
+            node = node->left;
+        }
+        return node;
+    }
+
+    AVLNode* remove(AVLNode* node, int key) {
+        if (!node) return nullptr;
+        if (key < node->key) {
+            node->left = remove(node->left, key);
+        } else if (key > node->key) {
+            node->right = remove(node->right, key);
+        } else {
+            if (!node->left || !node->right) {
+                AVLNode* temp = node->left ? node->left : node->right;
+                if (!temp) {
+                    temp = node;
+                    node = nullptr;
+                } else {
+                    *node = *temp;
+                }
+                delete temp;
+            } else {
+                AVLNode* temp = findMin(node->right);
+                node->key = temp->key;
+                node->right = remove(node->right, temp->key);
+            }
+        }
+        if (!node) return nullptr;
+        return balance(node);
+    }
+
+    void destroy(AVLNode* node) {
+        if (!node) return;
+        destroy(node->left);
+        destroy(node->right);
+        delete node;
+    }
+
+public:
+    AVLTree() : root(nullptr) {}
+    ~AVLTree() { destroy(root); }
+
+    void insert(int key) {
+        root = insert(root, key);
+    }
+
+    void remove(int key) {
+        root = remove(root, key);
+    }
+
+    bool contains(int key) const {
+        AVLNode* node = root;
+        while (node && node->key != key) {
+            node = key < node->key ? node->left : node->right;
+        }
+        return node != nullptr;
+    }
+};
+
+enum Color { RED, BLACK };
+
+// Узел красно-чёрного дерева
+struct RBNode {
+    int key;
+    RBNode* left;
+    RBNode* right;
+    RBNode* parent;
+    Color color;
+    int size; // Размер поддерева
+
+    RBNode(int k) : key(k), left(nullptr), right(nullptr), parent(nullptr), color(RED), size(1) {}
+};
+
+// Красно-чёрное дерево на указателях (вставка, удаление и поиск)
+class RedBlackTree {
+private:
+    RBNode* root;
+    RBNode* nil;
+
+    void leftRotate(RBNode* x) {
+        RBNode* y = x->right;
+        x->right = y->left;
+        if (y->left != nil) y->left->parent = x;
+        y->parent = x->parent;
+        if (x->parent == nil) {
+            root = y;
+        } else if (x == x->parent->left) {
+            x->parent->left = y;
+        } else {
+            x->parent->right = y;
+        }
+        y->left = x;
+        x->parent = y;
+        y->size = x->size;
+        x->size = 1 + x->left->size + x->right->size;
+    }
+
+    void rightRotate(RBNode* y) {
+        RBNode* x = y->left;
+        y->left = x->right;
+        if (x->right != nil) x->right->parent = y;
+        x->parent = y->parent;
+        if (y->parent == nil) {
+            root = x;
+        } else if (y == y->parent->right) {
+            y->parent->right = x;
+        } else {
+            y->parent->left = x;
+        }
+        x->right = y;
+        y->parent = x;
+        x->size = y->size;
+        y->size = 1 + y->left->size + y->right->size;
+    }
+
+    void insertFixup(RBNode* z) {
+        while (z->parent->color == RED) {
+            RBNode* grand = z->parent->parent;
+            bool parentIsLeft = z->parent == grand->left;
+            RBNode* uncle = parentIsLeft ? grand->right : grand->left;
+            if (uncle->color == RED) {
+                z->parent->color = BLACK;
+                uncle->color = BLACK;
+                grand->color = RED;
+                z = grand;
+            } else {
+                if (parentIsLeft && z == z->parent->right) {
+                    z = z->parent;
+                    leftRotate(z);
+                } else if (!parentIsLeft && z == z->parent->left) {
+                    z = z->parent;
+                    rightRotate(z);
+                }
+                z->parent->color = BLACK;
+                z->parent->parent->color = RED;
+                if (parentIsLeft) {
+                    rightRotate(z->parent->parent);
+                } else {
+                    leftRotate(z->parent->parent);
+                }
+            }
+        }
+        root->color = BLACK;
+    }
+
+    void updateSize(RBNode* node) {
+        node->size = 1 + node->left->size + node->right->size;
+    }
+
+    void deleteFixup(RBNode* x) {
+        while (x != root && x->color == BLACK) {
+            bool isLeft = x == x->parent->left;
+            RBNode* w = isLeft ? x->parent->right : x->parent->left;
+            if (w->color == RED) {
+                w->color = BLACK;
+                x->parent->color = RED;
+                if (isLeft) leftRotate(x->parent); else rightRotate(x->parent);
+                w = isLeft ? x->parent->right : x->parent->left;
+            }
+            RBNode* nearChild = isLeft ? w->left : w->right;
+            RBNode* farChild = isLeft ? w->right : w->left;
+            if (nearChild->color == BLACK && farChild->color == BLACK) {
+                w->color = RED;
+                x = x->parent;
+            } else {
+                if (farChild->color == BLACK) {
+                    nearChild->color = BLACK;
+                    w->color = RED;
+                    if (isLeft) rightRotate(w); else leftRotate(w);
+                    w = isLeft ? x->parent->right : x->parent->left;
+                }
+                w->color = x->parent->color;
+                x->parent->color = BLACK;
+                (isLeft ? w->right : w->left)->color = BLACK;
+                if (isLeft) leftRotate(x->parent); else rightRotate(x->parent);
+                x = root;
+            }
+        }
+        x->color = BLACK;
+    }
+
+    RBNode* minimum(RBNode* node) const {
+        while (node->left != nil) {
+            node = node->left;
+        }
+        return node;
+    }
+
+    void transplant(RBNode* u, RBNode* v) {
+        if (u->parent == nil) {
+            root = v;
+        } else if (u == u->parent->left) {
+            u->parent->left = v;
+        } else {
+            u->parent->right = v;
+        }
+        v->parent = u->parent;
+    }
+
+    void destroy(RBNode* node) {
+        if (node == nil) return;
+        destroy(node->left);
+        destroy(node->right);
+        delete node;
+    }
+
+public:
+    RedBlackTree() {
+        nil = new RBNode(0);
+        nil->color = BLACK;
+        nil->size = 0;
+        root = nil;
+    }
+
+    ~RedBlackTree() {
+        destroy(root);
+        delete nil;
+    }
+
+    void insert(int key) {
+        RBNode* y = nil;
+        RBNode* x = root;
+        while (x != nil) {
+            y = x;
+            ++x->size;
+            x = key < x->key ? x->left : x->right;
+        }
+        RBNode* z = new RBNode(key);
+        z->parent = y;
+        z->left = z->right = nil;
+        if (y == nil) {
+            root = z;
+        } else if (key < y->key) {
+            y->left = z;
+        } else {
+            y->right = z;
+        }
+        insertFixup(z);
+    }
+
+    void remove(int key) {
+        RBNode* z = root;
+        while (z != nil && z->key != key) {
+            z = key < z->key ? z->left : z->right;
+        }
+        if (z == nil) return;
+
+        RBNode* y = z;
+        RBNode* x;
+        Color yOriginalColor = y->color;
+        if (z->left == nil) {
+            x = z->right;
+            transplant(z, z->right);
+        } else if (z->right == nil) {
+            x = z->left;
+            transplant(z, z->left);
+        } else {
+            y = minimum(z->right);
+            yOriginalColor = y->color;
+            x = y->right;
+            if (y->parent == z) {
+                x->parent = y;
+            } else {
+                transplant(y, y->right);
+                y->right = z->right;
+                y->right->parent = y;
+            }
+            transplant(z, y);
+            y->left = z->left;
+            y->left->parent = y;
+            y->color = z->color;
+        }
+
+        // Размеры на пути к корню (nil->parent выставлен трансплантацией)
+        for (RBNode* node = x->parent; node != nil; node = node->parent) {
+            updateSize(node);
+        }
+        if (yOriginalColor == BLACK) {
+            deleteFixup(x);
+        }
+        delete z;
+    }
+
+    bool contains(int key) const {
+        RBNode* node = root;
+        while (node != nil && node->key != key) {
+            node = key < node->key ? node->left : node->right;
+        }
+        return node != nil;
+    }
+};
+
+// Узел рандомизированного BST
+struct Node {
+    int key;
+    Node* left;
+    Node* right;
+    int size; // Размер поддерева
+
+    Node(int k) : key(k), left(nullptr), right(nullptr), size(1) {}
+};
+
+// Рандомизированное BST на указателях (вставка, удаление и поиск)
+class RandomizedBST {
+private:
+    Node* root;
+    mt19937 gen;
+
+    int getSize(Node* node) const {
+        return node ? node->size : 0;
+    }
+
+    void updateSize(Node* node) {
+        node->size = 1 + getSize(node->left) + getSize(node->right);
+    }
+
+    Node* insertRoot(Node* node, int key) {
+        if (!node) return new Node(key);
+        if (key < node->key) {
+            node->left = insertRoot(node->left, key);
+            Node* newRoot = node->left;
+            node->left = newRoot->right;
+            newRoot->right = node;
+            updateSize(node);
+            updateSize(newRoot);
+            return newRoot;
+        }
+        node->right = insertRoot(node->right, key);
+        Node* newRoot = node->right;
+        node->right = newRoot->left;
+        newRoot->left = node;
+        updateSize(node);
+        updateSize(newRoot);
+        return newRoot;
+    }
+
+    Node* merge(Node* left, Node* right) {
+        if (!left) return right;
+        if (!right) return left;
+        if (uniform_int_distribution<>(0, getSize(left) + getSize(right) - 1)(gen) < getSize(left)) {
+            left->right = merge(left->right, right);
+            updateSize(left);
+            return left;
+        }
+        right->left = merge(left, right->left);
+        updateSize(right);
+        return right;
+    }
+
+    Node* remove(Node* node, int key) {
+        if (!node) return nullptr;
+        if (key == node->key) {
+            Node* result = merge(node->left, node->right);
+            delete node;
+            return result;
+        }
+        if (key < node->key) {
+            node->left = remove(node->left, key);
+        } else {
+            node->right = remove(node->right, key);
+        }
+        updateSize(node);
+        return node;
+    }
+
+    void destroy(Node* node) {
+        if (!node) return;
+        destroy(node->left);
+        destroy(node->right);
+        delete node;
+    }
+
+public:
+    RandomizedBST() : root(nullptr), gen(random_device{}()) {}
+    ~RandomizedBST() { destroy(root); }
+
+    // Как в randomisedBST.cpp: с вероятностью 1/(n+1) вставка в корень,
+    // иначе обычная вставка в лист с увеличением размеров на спуске
+    void insert(int key) {
+        if (!root) {
+            root = new Node(key);
+            return;
+        }
+        if (uniform_int_distribution<>(0, getSize(root))(gen) == 0) {
+            root = insertRoot(root, key);
+            return;
+        }
+        Node* parent = nullptr;
+        for (Node* node = root; node; node = key < node->key ? node->left : node->right) {
+            parent = node;
+            ++node->size;
+        }
+        if (key < parent->key) {
+            parent->left = new Node(key);
+        } else {
+            parent->right = new Node(key);
+        }
+    }
+
+    void remove(int key) {
+        root = remove(root, key);
+    }
+
+    bool contains(int key) const {
+        Node* node = root;
+        while (node && node->key != key) {
+            node = key < node->key ? node->left : node->right;
+        }
+        return node != nullptr;
+    }
+};
+
+// ---------------- Компактные деревья ----------------
+
+// Пул узлов с 32-битной адресацией. Индекс 0 зарезервирован под пустую ссылку
+// (или фиктивный лист), освобождённые узлы связываются через поле key.
+template <typename CompactNode>
+class NodePool {
+private:
+    vector<CompactNode> nodes;
+    uint32_t freeHead;
+    uint32_t limit; // Максимальный индекс, помещающийся в упакованную ссылку
+
+public:
+    explicit NodePool(uint32_t limit) : nodes(1), freeHead(0), limit(limit) {}
+
+    // Индекс нового узла; ссылки на узлы после вызова могут стать недействительными
+    uint32_t allocate() {
+        if (freeHead) {
+            uint32_t index = freeHead;
+            freeHead = static_cast<uint32_t>(nodes[index].key);
+            nodes[index] = CompactNode();
+            return index;
+        }
+        if (nodes.size() > limit) {
+            throw overflow_error("Node pool index limit reached");
+        }
+        nodes.emplace_back();
+        return static_cast<uint32_t>(nodes.size() - 1);
+    }
+
+    void release(uint32_t index) {
+        nodes[index].key = static_cast<int>(freeHead);
+        freeHead = index;
+    }
+
+    CompactNode& operator[](uint32_t index) { return nodes[index]; }
+    const CompactNode& operator[](uint32_t index) const { return nodes[index]; }
+
+    void reserve(size_t count) { nodes.reserve(count + 1); }
+
+    size_t bytes() const { return nodes.capacity() * sizeof(CompactNode); }
+};
+
+// Узел компактного AVL-дерева: 12 байт вместо 32.
+// Высота (не больше 63) хранится в старших 6 битах правой ссылки rightHeight.
+struct CompactAVLNode {
+    int key = 0;
+    uint32_t left = 0;
+    uint32_t rightHeight = 0;
+};
+
+class CompactAVLTree {
+private:
+    static const int HEIGHT_SHIFT = 26;
+    static const uint32_t INDEX_MASK = (1u << HEIGHT_SHIFT) - 1;
+
+    NodePool<CompactAVLNode> pool;
+    uint32_t root;
+
+    uint32_t left(uint32_t node) const { return pool[node].left; }
+    uint32_t right(uint32_t node) const { return pool[node].rightHeight & INDEX_MASK; }
+    int height(uint32_t node) const { return node ? static_cast<int>(pool[node].rightHeight >> HEIGHT_SHIFT) : 0; }
+
+    void setLeft(uint32_t node, uint32_t child) { pool[node].left = child; }
+    void setRight(uint32_t node, uint32_t child) {
+        pool[node].rightHeight = (pool[node].rightHeight & ~INDEX_MASK) | child;
+    }
+    void updateHeight(uint32_t node) {
+        uint32_t h = 1 + max(height(left(node)), height(right(node)));
+        pool[node].rightHeight = (h << HEIGHT_SHIFT) | right(node);
+    }
+
+    uint32_t rotateRight(uint32_t y) {
+        uint32_t x = left(y);
+        setLeft(y, right(x));
+        setRight(x, y);
+        updateHeight(y);
+        updateHeight(x);
+        return x;
+    }
+
+    uint32_t rotateLeft(uint32_t x) {
+        uint32_t y = right(x);
+        setRight(x, left(y));
+        setLeft(y, x);
+        updateHeight(x);
+        updateHeight(y);
+        return y;
+    }
+
+    uint32_t balance(uint32_t node) {
+        updateHeight(node);
+        int balanceFactor = height(left(node)) - height(right(node));
+        if (balanceFactor > 1) {
+            if (height(left(left(node))) < height(right(left(node)))) {
+                setLeft(node, rotateLeft(left(node)));
+            }
+            return rotateRight(node);
+        }
+        if (balanceFactor < -1) {
+            if (height(right(right(node))) < height(left(right(node)))) {
+                setRight(node, rotateRight(right(node)));
+            }
+            return rotateLeft(node);
+        }
+        return node;
+    }
+
+    uint32_t insert(uint32_t node, int key) {
+        if (!node) {
+            uint32_t created = pool.allocate();
+            pool[created].key = key;
+            pool[created].rightHeight = 1u << HEIGHT_SHIFT;
+            return created;
+        }
+        int nodeKey = pool[node].key;
+        if (key < nodeKey) {
+            uint32_t child = insert(left(node), key);
+            setLeft(node, child);
+        } else if (key > nodeKey) {
+            uint32_t child = insert(right(node), key);
+            setRight(node, child);
+        } else {
+            return node;
+        }
+        return balance(node);
+    }
+
+    uint32_t remove(uint32_t node, int key) {
+        if (!node) return 0;
+        int nodeKey = pool[node].key;
+        if (key < nodeKey) {
+            setLeft(node, remove(left(node), key));
+        } else if (key > nodeKey) {
+            setRight(node, remove(right(node), key));
+        } else {
+            if (!left(node) || !right(node)) {
+                uint32_t child = left(node) ? left(node) : right(node);
+                pool.release(node);
+                return child;
+            }
+            uint32_t successor = right(node);
+            while (left(successor)) successor = left(successor);
+            pool[node].key = pool[successor].key;
+            setRight(node, remove(right(node), pool[successor].key));
+        }
+        return balance(node);
+    }
+
+    // Высота поддерева или -1, если нарушен порядок ключей, баланс или
+    // сохранённая высота
+    int checkHeight(uint32_t node, long long lo, long long hi) const {
+        if (!node) return 0;
+        int key = pool[node].key;
+        if (key <= lo || key >= hi) return -1;
+        int leftHeight = checkHeight(left(node), lo, key);
+        int rightHeight = checkHeight(right(node), key, hi);
+        if (leftHeight < 0 || rightHeight < 0 || abs(leftHeight - rightHeight) > 1) return -1;
+        int h = 1 + max(leftHeight, rightHeight);
+        return height(node) == h ? h : -1;
+    }
+
+public:
+    CompactAVLTree() : pool(INDEX_MASK), root(0) {}
+
+    void reserve(size_t count) { pool.reserve(count); }
+
+    void insert(int key) {
+        root = insert(root, key);
+    }
+
+    void remove(int key) {
+        root = remove(root, key);
+    }
+
+    bool contains(int key) const {
+        uint32_t node = root;
+        while (node) {
+            const CompactAVLNode& current = pool[node];
+            if (current.key == key) return true;
+            // Сначала выбор из двух полей (cmov), маска - уже после него;
+            // у левой ссылки старших битов нет, так что маска ей не мешает
+            uint32_t next = key < current.key ? current.left : current.rightHeight;
+            node = next & INDEX_MASK;
+        }
+        return false;
+    }
+
+    bool isValid() const {
+        return checkHeight(root, LLONG_MIN, LLONG_MAX) >= 0;
+    }
+
+    size_t bytes() const { return pool.bytes(); }
+};
+
+// Узел компактного красно-чёрного дерева: 16 байт вместо 40.
+// Цвет хранится в старшем бите ссылки на родителя; индекс 0 - фиктивный лист nil.
+struct CompactRBNode {
+    int key = 0;
+    uint32_t left = 0;
+    uint32_t right = 0;
+    uint32_t parentColor = 0;
+};
+
+class CompactRedBlackTree {
+private:
+    static const uint32_t RED_BIT = 1u << 31;
+    static const uint32_t INDEX_MASK = RED_BIT - 1;
+    static const uint32_t NIL = 0;
+
+    NodePool<CompactRBNode> pool;
+    uint32_t root;
+
+    uint32_t& left(uint32_t node) { return pool[node].left; }
+    uint32_t& right(uint32_t node) { return pool[node].right; }
+    uint32_t parent(uint32_t node) const { return pool[node].parentColor & INDEX_MASK; }
+    bool isRed(uint32_t node) const { return pool[node].parentColor & RED_BIT; }
+
+    void setParent(uint32_t node, uint32_t p) {
+        pool[node].parentColor = (pool[node].parentColor & RED_BIT) | p;
+    }
+    void setColor(uint32_t node, Color color) {
+        pool[node].parentColor = (pool[node].parentColor & INDEX_MASK) | (color == RED ? RED_BIT : 0);
+    }
+
+    void replaceChild(uint32_t p, uint32_t old, uint32_t node) {
+        if (p == NIL) {
+            root = node;
+        } else if (old == left(p)) {
+            left(p) = node;
+        } else {
+            right(p) = node;
+        }
+    }
+
+    void leftRotate(uint32_t x) {
+        uint32_t y = right(x);
+        right(x) = left(y);
+        if (left(y) != NIL) setParent(left(y), x);
+        setParent(y, parent(x));
+        replaceChild(parent(x), x, y);
+        left(y) = x;
+        setParent(x, y);
+    }
+
+    void rightRotate(uint32_t y) {
+        uint32_t x = left(y);
+        left(y) = right(x);
+        if (right(x) != NIL) setParent(right(x), y);
+        setParent(x, parent(y));
+        replaceChild(parent(y), y, x);
+        right(x) = y;
+        setParent(y, x);
+    }
+
+    void insertFixup(uint32_t z) {
+        while (isRed(parent(z))) {
+            uint32_t grand = parent(parent(z));
+            bool parentIsLeft = parent(z) == left(grand);
+            uint32_t uncle = parentIsLeft ? right(grand) : left(grand);
+            if (isRed(uncle)) {
+                setColor(parent(z), BLACK);
+                setColor(uncle, BLACK);
+                setColor(grand, RED);
+                z = grand;
+            } else {
+                if (parentIsLeft && z == right(parent(z))) {
+                    z = parent(z);
+                    leftRotate(z);
+                } else if (!parentIsLeft && z == left(parent(z))) {
+                    z = parent(z);
+                    rightRotate(z);
+                }
+                setColor(parent(z), BLACK);
+                setColor(parent(parent(z)), RED);
+                if (parentIsLeft) {
+                    rightRotate(parent(parent(z)));
+                } else {
+                    leftRotate(parent(parent(z)));
+                }
+            }
+        }
+        setColor(root, BLACK);
+    }
+
+    void transplant(uint32_t u, uint32_t v) {
+        replaceChild(parent(u), u, v);
+        setParent(v, parent(u));
+    }
+
+    void deleteFixup(uint32_t x) {
+        while (x != root && !isRed(x)) {
+            bool isLeft = x == left(parent(x));
+            uint32_t w = isLeft ? right(parent(x)) : left(parent(x));
+            if (isRed(w)) {
+                // Случай 1: брат красный
+                setColor(w, BLACK);
+                setColor(parent(x), RED);
+                if (isLeft) leftRotate(parent(x)); else rightRotate(parent(x));
+                w = isLeft ? right(parent(x)) : left(parent(x));
+            }
+            uint32_t nearChild = isLeft ? left(w) : right(w);
+            uint32_t farChild = isLeft ? right(w) : left(w);
+            if (!isRed(nearChild) && !isRed(farChild)) {
+                // Случай 2: оба ребенка брата черные
+                setColor(w, RED);
+                x = parent(x);
+            } else {
+                if (!isRed(farChild)) {
+                    // Случай 3: дальний ребенок брата черный
+                    setColor(nearChild, BLACK);
+                    setColor(w, RED);
+                    if (isLeft) rightRotate(w); else leftRotate(w);
+                    w = isLeft ? right(parent(x)) : left(parent(x));
+                }
+                // Случай 4
+                setColor(w, isRed(parent(x)) ? RED : BLACK);
+                setColor(parent(x), BLACK);
+                setColor(isLeft ? right(w) : left(w), BLACK);
+                if (isLeft) leftRotate(parent(x)); else rightRotate(parent(x));
+                x = root;
+            }
+        }
+        setColor(x, BLACK);
+    }
+
+    int blackHeight(uint32_t node, long long lo, long long hi) {
+        if (node == NIL) return 1;
+        int key = pool[node].key;
+        if (key < lo || key > hi) return -1;
+        if (isRed(node) && (isRed(left(node)) || isRed(right(node)))) return -1;
+        if (left(node) != NIL && parent(left(node)) != node) return -1;
+        if (right(node) != NIL && parent(right(node)) != node) return -1;
+        int leftHeight = blackHeight(left(node), lo, key);
+        int rightHeight = blackHeight(right(node), key, hi);
+        if (leftHeight < 0 || leftHeight != rightHeight) return -1;
+        return leftHeight + (isRed(node) ? 0 : 1);
+    }
+
+public:
+    CompactRedBlackTree() : pool(INDEX_MASK), root(NIL) {}
+
+    void reserve(size_t count) { pool.reserve(count); }
+
+    void insert(int key) {
+        uint32_t y = NIL;
+        uint32_t x = root;
+        while (x != NIL) {
+            y = x;
+            x = key < pool[x].key ? left(x) : right(x);
+        }
+        uint32_t z = pool.allocate();
+        pool[z].key = key;
+        pool[z].parentColor = y | RED_BIT;
+        if (y == NIL) {
+            root = z;
+        } else if (key < pool[y].key) {
+            left(y) = z;
+        } else {
+            right(y) = z;
+        }
+        insertFixup(z);
+    }
+
+    void remove(int key) {
+        uint32_t z = root;
+        while (z != NIL && pool[z].key != key) {
+            z = key < pool[z].key ? left(z) : right(z);
+        }
+        if (z == NIL) return;
+
+        uint32_t y = z;
+        uint32_t x;
+        bool yWasRed = isRed(y);
+        if (left(z) == NIL) {
+            x = right(z);
+            transplant(z, right(z));
+        } else if (right(z) == NIL) {
+            x = left(z);
+            transplant(z, left(z));
+        } else {
+            y = right(z);
+            while (left(y) != NIL) y = left(y);
+            yWasRed = isRed(y);
+            x = right(y);
+            if (parent(y) == z) {
+                setParent(x, y);
+            } else {
+                transplant(y, right(y));
+                right(y) = right(z);
+                setParent(right(y), y);
+            }
+            transplant(z, y);
+            left(y) = left(z);
+            setParent(left(y), y);
+            setColor(y, isRed(z) ? RED : BLACK);
+        }
+        if (!yWasRed) {
+            deleteFixup(x);
+        }
+        pool.release(z);
+    }
+
+    bool contains(int key) const {
+        uint32_t node = root;
+        while (node != NIL) {
+            const CompactRBNode& current = pool[node];
+            if (current.key == key) return true;
+            node = key < current.key ? current.left : current.right;
+        }
+        return false;
+    }
+
+    // Проверка свойств RB-дерева и ссылок на родителей
+    bool isValid() {
+        return !isRed(root) && blackHeight(root, LLONG_MIN, LLONG_MAX) > 0;
+    }
+
+    size_t bytes() const { return pool.bytes(); }
+};
+
+// Узел компактного рандомизированного BST: 16 байт вместо 32
+struct CompactNode {
+    int key = 0;
+    uint32_t left = 0;
+    uint32_t right = 0;
+    int size = 0;
+};
+
+class CompactRandomizedBST {
+private:
+    NodePool<CompactNode> pool;
+    uint32_t root;
+    mt19937 gen;
+
+    int getSize(uint32_t node) const { return node ? pool[node].size : 0; }
+
+    void updateSize(uint32_t node) {
+        pool[node].size = 1 + getSize(pool[node].left) + getSize(pool[node].right);
+    }
+
+    uint32_t newNode(int key) {
+        uint32_t node = pool.allocate();
+        pool[node].key = key;
+        pool[node].size = 1;
+        return node;
+    }
+
+    uint32_t insertRoot(uint32_t node, int key) {
+        if (!node) return newNode(key);
+        if (key < pool[node].key) {
+            uint32_t newRoot = insertRoot(pool[node].left, key);
+            pool[node].left = pool[newRoot].right;
+            pool[newRoot].right = node;
+            updateSize(node);
+            updateSize(newRoot);
+            return newRoot;
+        }
+        uint32_t newRoot = insertRoot(pool[node].right, key);
+        pool[node].right = pool[newRoot].left;
+        pool[newRoot].left = node;
+        updateSize(node);
+        updateSize(newRoot);
+        return newRoot;
+    }
+
+
+    uint32_t merge(uint32_t left, uint32_t right) {
+        if (!left) return right;
+        if (!right) return left;
+        if (uniform_int_distribution<>(0, getSize(left) + getSize(right) - 1)(gen) < getSize(left)) {
+            pool[left].right = merge(pool[left].right, right);
+            updateSize(left);
+            return left;
+        }
+        pool[right].left = merge(left, pool[right].left);
+        updateSize(right);
+        return right;
+    }
+
+    uint32_t remove(uint32_t node, int key) {
+        if (!node) return 0;
+        if (key == pool[node].key) {
+            uint32_t result = merge(pool[node].left, pool[node].right);
+            pool.release(node);
+            return result;
+        }
+        if (key < pool[node].key) {
+            pool[node].left = remove(pool[node].left, key);
+        } else {
+            pool[node].right = remove(pool[node].right, key);
+        }
+        updateSize(node);
+        return node;
+    }
+
+    // Размер поддерева или -1, если нарушен порядок ключей или размер
+    int checkSize(uint32_t node, long long lo, long long hi) const {
+        if (!node) return 0;
+        int key = pool[node].key;
+        if (key < lo || key > hi) return -1; // Повторы допустимы, как и во вставке
+        int leftSize = checkSize(pool[node].left, lo, key);
+        int rightSize = checkSize(pool[node].right, key, hi);
+        if (leftSize < 0 || rightSize < 0 || pool[node].size != leftSize + rightSize + 1) return -1;
+        return pool[node].size;
+    }
+
+public:
+    CompactRandomizedBST() : pool(UINT32_MAX - 1), root(0), gen(random_device{}()) {}
+
+    void reserve(size_t count) { pool.reserve(count); }
+
+    // Тот же алгоритм, что у дерева на указателях (randomisedBST.cpp)
+    void insert(int key) {
+        if (!root) {
+            root = newNode(key);
+            return;
+        }
+        if (uniform_int_distribution<>(0, pool[root].size)(gen) == 0) {
+            root = insertRoot(root, key);
+            return;
+        }
+        uint32_t parent = 0;
+        for (uint32_t node = root; node; node = key < pool[node].key ? pool[node].left : pool[node].right) {
+            parent = node;
+            ++pool[node].size;
+        }
+        uint32_t created = newNode(key);
+        if (key < pool[parent].key) {
+            pool[parent].left = created;
+        } else {
+            pool[parent].right = created;
+        }
+    }
+
+    void remove(int key) {
+        root = remove(root, key);
+    }
+
+    bool contains(int key) const {
+        uint32_t node = root;
+        while (node) {
+            const CompactNode& current = pool[node];
+            if (current.key == key) return true;
+            node = key < current.key ? current.left : current.right;
+        }
+        return false;
+    }
+
+    int size() const { return getSize(root); }
+
+    bool isValid() const {
+        return checkSize(root, LLONG_MIN, LLONG_MAX) >= 0;
+    }
+
+    size_t bytes() const { return pool.bytes(); }
+};
+
+// Время (нс на запрос) серии поисков
+template <typename TreeType>
+double measureLookups(const TreeType& tree, const vector<int>& queries, size_t& found) {
+    auto start = high_resolution_clock::now();
+    size_t hits = 0;
+    for (int key : queries) {
+        hits += tree.contains(key);
+    }
+    auto end = high_resolution_clock::now();
+    found = hits;
+    return duration_cast<nanoseconds>(end - start).count() / static_cast<double>(queries.size());
+}
+
+// Время (нс на удаление) удаления каждого второго ключа из elements
+template <typename TreeType>
+double measureRemovals(TreeType& tree, const vector<int>& elements) {
+    auto start = high_resolution_clock::now();
+    for (size_t j = 0; j < elements.size(); j += 2) {
+        tree.remove(elements[j]);
+    }
+    auto end = high_resolution_clock::now();
+    return duration_cast<nanoseconds>(end - start).count() / static_cast<double>((elements.size() + 1) / 2);
+}
+
+// Построение обоих вариантов дерева, сравнение поиска, затем удаление
+// половины ключей с проверкой инвариантов компактного дерева
+template <typename PointerTree, typename CompactTree>
+void compareLayouts(const string& name, size_t pointerNodeBytes, const vector<int>& elements,
+                    const vector<int>& queries, ofstream& csv) {
+    PointerTree pointerTree;
+    for (int elem : elements) {
+        pointerTree.insert(elem);
+    }
+    CompactTree compactTree;
+    compactTree.reserve(elements.size());
+    for (int elem : elements) {
+        compactTree.insert(elem);
+    }
+
+    size_t pointerFound, compactFound;
+    double pointerTime = measureLookups(pointerTree, queries, pointerFound);
+    double compactTime = measureLookups(compactTree, queries, compactFound);
+    if (pointerFound != compactFound) {
+        throw logic_error("Compact " + name + " disagrees with the pointer version");
+    }
+
+    double compactBytes = static_cast<double>(compactTree.bytes()) / elements.size();
+
+    double pointerRemoveTime = measureRemovals(pointerTree, elements);
+    double compactRemoveTime = measureRemovals(compactTree, elements);
+    if (!compactTree.isValid()) {
+        throw logic_error("Compact " + name + " invariants violated after removals");
+    }
+    measureLookups(pointerTree, queries, pointerFound);
+    measureLookups(compactTree, queries, compactFound);
+    if (pointerFound != compactFound) {
+        throw logic_error("Compact " + name + " disagrees with the pointer version after removals");
+    }
+
+    cout << "  " << name << ": pointer " << pointerTime << " ns/lookup (" << pointerNodeBytes
+         << " B/node), compact " << compactTime << " ns/lookup (" << compactBytes
+         << " B/key), speedup " << pointerTime / compactTime << "x; remove " << pointerRemoveTime
+         << " / " << compactRemoveTime << " ns" << endl;
+    csv << elements.size() << "," << name << "," << pointerNodeBytes << "," << compactBytes << ","
+        << pointerTime << "," << compactTime << "," << pointerRemoveTime << "," << compactRemoveTime << "\n";
+}
+
+// Сравнение поиска и удаления в деревьях на указателях и в компактных деревьях
+void testCompactTrees() {
+    const int QUERIES = 1000000;
+    mt19937 gen(random_device{}());
+
+    ofstream csv("compact_trees_results.csv");
+    csv << "N,Tree,Pointer_Bytes_Per_Node,Compact_Bytes_Per_Key,Pointer_Lookup_ns,Compact_Lookup_ns,Pointer_Remove_ns,Compact_Remove_ns\n";
+
+    for (int i = 18; i <= 22; i += 2) {
+        const size_t N = 1 << i; // 2^i
+        cout << "Testing N = 2^" << i << " = " << N << "..." << endl;
+
+        // Уникальные случайные ключи (у всех деревьев одинаковый размер)
+        vector<int> elements(N);
+        for (size_t j = 0; j < N; ++j) {
+            elements[j] = static_cast<int>(j * 10 + gen() % 10);
+        }
+        shuffle(elements.begin(), elements.end(), gen);
+
+        // Половина запросов - существующие ключи, половина - случайные
+        vector<int> queries(QUERIES);
+        for (int j = 0; j < QUERIES; ++j) {
+            queries[j] = j % 2 ? elements[gen() % N] : static_cast<int>(gen() % (10 * N));
+        }
+
+        compareLayouts<AVLTree, CompactAVLTree>("AVL", sizeof(AVLNode), elements, queries, csv);
+        compareLayouts<RedBlackTree, CompactRedBlackTree>("RedBlack", sizeof(RBNode), elements, queries, csv);
+        compareLayouts<RandomizedBST, CompactRandomizedBST>("Randomized", sizeof(Node), elements, queries, csv);
+        cout << endl;
+    }
+
+    cout << "Results saved to compact_trees_results.csv" << endl;
+}
+
+int main() {
+    try {
+        testCompactTrees();
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,1257 @@
+/*
+9) Конкурентное упорядоченное отображение на основе красно-чёрного дерева:
+   оптимистичные читатели с проверкой через seqlock и писатели,
+   объединяющие операции (flat combining), сравнение с глобальным мьютексом
+   и со списком с пропусками без блокировок, где писатели не ждут друг друга.
+ */
+
+// реализация конкурентного красно-чёрного дерева
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <fstream>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <stdexcept>
+#include <climits>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+using namespace std;
+using namespace std::chrono;
+
+enum Color { RED, BLACK };
+
+// Узел конкурентного дерева. Читатели обращаются только к key, value и ссылкам
+// на детей, поэтому только они атомарны; parent и color меняет лишь писатель.
+struct CRBNode {
+    const int key;
+    atomic<int> value;
+    atomic<CRBNode*> left;
+    atomic<CRBNode*> right;
+    CRBNode* parent;
+    Color color;
+    CRBNode* nextRetired; // Список узлов, ожидающих освобождения
+
+    CRBNode(int k, int v) : key(k), value(v), left(nullptr), right(nullptr),
+                            parent(nullptr), color(RED), nextRetired(nullptr) {}
+};
+
+// Реестр потоков: каждому живому потоку выдаётся свой индекс слота,
+// освобождаемый при завершении потока
+class ThreadRegistry {
+public:
+    static const int MAX_THREADS = 64;
+
+    static int index() {
+        thread_local Holder holder;
+        return holder.slot;
+    }
+
+    // Верхняя граница выданных индексов (для обхода слотов)
+    static int highWater() {
+        return used().highWater.load(memory_order_acquire);
+    }
+
+private:
+    struct Slots {
+        atomic<bool> taken[MAX_THREADS] = {};
+        atomic<int> highWater{0};
+    };
+
+    static Slots& used() {
+        static Slots slots;
+        return slots;
+    }
+
+    struct Holder {
+        int slot;
+
+        Holder() : slot(-1) {
+            Slots& slots = used();
+            for (int i = 0; i < MAX_THREADS; ++i) {
+                bool expected = false;
+                if (slots.taken[i].compare_exchange_strong(expected, true)) {
+                    slot = i;
+                    break;
+                }
+            }
+            if (slot < 0) {
+                throw overflow_error("Too many threads for concurrent tree");
+            }
+            int high = slots.highWater.load();
+            while (high < slot + 1 && !slots.highWater.compare_exchange_weak(high, slot + 1)) {}
+        }
+
+        ~Holder() {
+            used().taken[slot].store(false);
+        }
+    };
+};
+
+// Конкурентное красно-чёрное дерево (отображение int -> int).
+// Читатели идут по дереву без блокировок и проверяют по счётчику версий
+// (seqlock), что за время спуска не было записи. Писатели публикуют операцию
+// в своём слоте; поток, захвативший мьютекс, выполняет все ожидающие операции
+// одним пакетом внутри одной секции записи. Удалённые узлы освобождаются
+// через эпохи, когда ни один читатель не может их видеть.
+class ConcurrentRedBlackTree {
+private:
+    static const int MAX_STEPS = 128;            // Высота RB-дерева из 2^32 узлов не больше 64
+    static const int OPTIMISTIC_ATTEMPTS = 16;   // Затем читатель берёт мьютекс
+
+    enum OpType { INSERT, REMOVE };
+    enum SlotState { EMPTY, PENDING, DONE };
+
+    // Слот операции писателя
+    struct alignas(64) WriteSlot {
+        atomic<int> state{EMPTY};
+        OpType op = INSERT;
+        int key = 0;
+        int value = 0;
+        bool result = false;
+    };
+
+    // Эпоха, в которой находится читатель (0 - вне дерева)
+    struct alignas(64) ReaderEpoch {
+        atomic<uint64_t> epoch{0};
+    };
+
+    atomic<CRBNode*> root;
+    CRBNode* nil;
+    atomic<uint64_t> sequence;   // Нечётное значение - идёт запись
+    mutex writeLock;
+    size_t count;
+
+    WriteSlot slots[ThreadRegistry::MAX_THREADS];
+    ReaderEpoch readers[ThreadRegistry::MAX_THREADS];
+    atomic<uint64_t> globalEpoch;
+    CRBNode* retired[3];        // Удалённые узлы по эпохам (epoch % 3)
+
+    // Доступ писателя к ссылкам; запись с release публикует инициализированный узел
+    CRBNode* left(CRBNode* node) const { return node->left.load(memory_order_relaxed); }
+    CRBNode* right(CRBNode* node) const { return node->right.load(memory_order_relaxed); }
+    void setLeft(CRBNode* node, CRBNode* child) { node->left.store(child, memory_order_release); }
+    void setRight(CRBNode* node, CRBNode* child) { node->right.store(child, memory_order_release); }
+    CRBNode* getRoot() const { return root.load(memory_order_relaxed); }
+    void setRoot(CRBNode* node) { root.store(node, memory_order_release); }
+
+    // Замена ребёнка parent с old на node (или корня)
+    void replaceChild(CRBNode* parent, CRBNode* old, CRBNode* node) {
+        if (parent == nil) {
+            setRoot(node);
+        } else if (old == left(parent)) {
+            setLeft(parent, node);
+        } else {
+            setRight(parent, node);
+        }
+    }
+
+    // Левый поворот
+    void leftRotate(CRBNode* x) {
+        CRBNode* y = right(x);
+        setRight(x, left(y));
+        if (left(y) != nil) {
+            left(y)->parent = x;
+        }
+        y->parent = x->parent;
+        replaceChild(x->parent, x, y);
+        setLeft(y, x);
+        x->parent = y;
+    }
+
+    // Правый поворот
+    void rightRotate(CRBNode* y) {
+        CRBNode* x = left(y);
+        setLeft(y, right(x));
+        if (right(x) != nil) {
+            right(x)->parent = y;
+        }
+        x->parent = y->parent;
+        replaceChild(y->parent, y, x);
+        setRight(x, y);
+        y->parent = x;
+    }
+
+    // Восстановление свойств после вставки
+    void insertFixup(CRBNode* z) {
+        while (z->parent->color == RED) {
+            CRBNode* grand = z->parent->parent;
+            if (z->parent == left(grand)) {
+                CRBNode* y = right(grand);
+
+                if (y->color == RED) {
+                    // Случай 1: дядя красный
+                    z->parent->color = BLACK;
+                    y->color = BLACK;
+                    grand->color = RED;
+                    z = grand;
+                } else {
+                    if (z == right(z->parent)) {
+                        // Случай 2: дядя черный, z - правый потомок
+                        z = z->parent;
+                        leftRotate(z);
+                    }
+                    // Случай 3: дядя черный, z - левый потомок
+                    z->parent->color = BLACK;
+                    z->parent->parent->color = RED;
+                    rightRotate(z->parent->parent);
+                }
+            } else {
+                // Симметричный случай
+                CRBNode* y = left(grand);
+
+                if (y->color == RED) {
+                    z->parent->color = BLACK;
+                    y->color = BLACK;
+                    grand->color = RED;
+                    z = grand;
+                } else {
+                    if (z == left(z->parent)) {
+                        z = z->parent;
+                        rightRotate(z);
+                    }
+                    z->parent->color = BLACK;
+                    z->parent->parent->color = RED;
+                    leftRotate(z->parent->parent);
+                }
+            }
+        }
+        getRoot()->color = BLACK;
+    }
+
+    // Восстановление свойств после удаления
+    void deleteFixup(CRBNode* x) {
+        while (x != getRoot() && x->color == BLACK) {
+            if (x == left(x->parent)) {
+                CRBNode* w = right(x->parent);
+
+                if (w->color == RED) {
+                    // Случай 1: брат красный
+                    w->color = BLACK;
+                    x->parent->color = RED;
+                    leftRotate(x->parent);
+                    w = right(x->parent);
+                }
+
+                if (left(w)->color == BLACK && right(w)->color == BLACK) {
+                    // Случай 2: оба ребенка брата черные
+                    w->color = RED;
+                    x = x->parent;
+                } else {
+                    if (right(w)->color == BLACK) {
+                        // Случай 3: правый ребенок брата черный
+                        left(w)->color = BLACK;
+                        w->color = RED;
+                        rightRotate(w);
+                        w = right(x->parent);
+                    }
+                    // Случай 4
+                    w->color = x->parent->color;
+                    x->parent->color = BLACK;
+                    right(w)->color = BLACK;
+                    leftRotate(x->parent);
+                    x = getRoot();
+                }
+            } else {
+                // Симметричный случай
+                CRBNode* w = left(x->parent);
+
+                if (w->color == RED) {
+                    w->color = BLACK;
+                    x->parent->color = RED;
+                    rightRotate(x->parent);
+                    w = left(x->parent);
+                }
+
+                if (right(w)->color == BLACK && left(w)->color == BLACK) {
+                    w->color = RED;
+                    x = x->parent;
+                } else {
+                    if (left(w)->color == BLACK) {
+                        right(w)->color = BLACK;
+                        w->color = RED;
+                        leftRotate(w);
+                        w = left(x->parent);
+                    }
+                    w->color = x->parent->color;
+                    x->parent->color = BLACK;
+                    left(w)->color = BLACK;
+                    rightRotate(x->parent);
+                    x = getRoot();
+                }
+            }
+        }
+        x->color = BLACK;
+    }
+
+    // Трансплантация поддерева
+    void transplant(CRBNode* u, CRBNode* v) {
+        replaceChild(u->parent, u, v);
+        v->parent = u->parent;
+    }
+
+    CRBNode* minimum(CRBNode* node) const {
+        while (left(node) != nil) {
+            node = left(node);
+        }
+        return node;
+    }
+
+    CRBNode* search(int key) const {
+        CRBNode* node = getRoot();
+        while (node != nil && node->key != key) {
+            node = key < node->key ? left(node) : right(node);
+        }
+        return node;
+    }
+
+    // Вставка или обновление значения (под мьютексом); true, если ключ новый
+    bool insertLocked(int key, int value) {
+        CRBNode* y = nil;
+        CRBNode* x = getRoot();
+        while (x != nil) {
+            if (key == x->key) {
+                x->value.store(value, memory_order_relaxed);
+                return false;
+            }
+            y = x;
+            x = key < x->key ? left(x) : right(x);
+        }
+
+        CRBNode* z = new CRBNode(key, value);
+        z->left.store(nil, memory_order_relaxed);
+        z->right.store(nil, memory_order_relaxed);
+        z->parent = y;
+        if (y == nil) {
+            setRoot(z);
+        } else if (key < y->key) {
+            setLeft(y, z);
+        } else {
+            setRight(y, z);
+        }
+        insertFixup(z);
+        ++count;
+        return true;
+    }
+
+    // Удаление (под мьютексом); узел откладывается до смены эпох
+    bool removeLocked(int key) {
+        CRBNode* z = search(key);
+        if (z == nil) return false;
+
+        CRBNode* y = z;
+        CRBNode* x;
+        Color yOriginalColor = y->color;
+
+        if (left(z) == nil) {
+            x = right(z);
+            transplant(z, right(z));
+        } else if (right(z) == nil) {
+            x = left(z);
+            transplant(z, left(z));
+        } else {
+            y = minimum(right(z));
+            yOriginalColor = y->color;
+            x = right(y);
+
+            if (y->parent == z) {
+                x->parent = y;
+            } else {
+                transplant(y, right(y));
+                setRight(y, right(z));
+                right(y)->parent = y;
+            }
+
+            // y сначала получает левое поддерево z, и только затем занимает его место,
+            // чтобы читатель, пришедший в y, не потерял левую ветвь
+            setLeft(y, left(z));
+            left(y)->parent = y;
+            transplant(z, y);
+            y->color = z->color;
+        }
+
+        if (yOriginalColor == BLACK) {
+            deleteFixup(x);
+        }
+
+        uint64_t epoch = globalEpoch.load(memory_order_relaxed);
+        z->nextRetired = retired[epoch % 3];
+        retired[epoch % 3] = z;
+        --count;
+        return true;
+    }
+
+    void freeList(CRBNode*& list) {
+        while (list) {
+            CRBNode* next = list->nextRetired;
+            delete list;
+            list = next;
+        }
+    }
+
+    // Переход к следующей эпохе, если все активные читатели уже в текущей;
+    // узлы, удалённые две эпохи назад, больше никому не видны
+    void tryAdvanceEpoch() {
+        atomic_thread_fence(memory_order_seq_cst);
+        uint64_t current = globalEpoch.load(memory_order_relaxed);
+        int high = ThreadRegistry::highWater();
+        for (int i = 0; i < high; ++i) {
+            uint64_t local = readers[i].epoch.load(memory_order_acquire);
+            if (local != 0 && local != current) return;
+        }
+        globalEpoch.store(current + 1, memory_order_release);
+        freeList(retired[(current + 1) % 3]);
+    }
+
+    // Выполнение всех опубликованных операций одной секцией записи
+    void combine() {
+        uint64_t seq = sequence.load(memory_order_relaxed);
+        sequence.store(seq + 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+
+        int high = ThreadRegistry::highWater();
+        for (int i = 0; i < high; ++i) {
+            WriteSlot& slot = slots[i];
+            if (slot.state.load(memory_order_acquire) != PENDING) continue;
+            slot.result = slot.op == INSERT ? insertLocked(slot.key, slot.value) : removeLocked(slot.key);
+            slot.state.store(DONE, memory_order_release);
+        }
+
+        sequence.store(seq + 2, memory_order_release);
+        tryAdvanceEpoch();
+    }
+
+    bool write(OpType op, int key, int value) {
+        WriteSlot& slot = slots[ThreadRegistry::index()];
+        slot.op = op;
+        slot.key = key;
+        slot.value = value;
+        slot.state.store(PENDING, memory_order_release);
+
+        while (slot.state.load(memory_order_acquire) != DONE) {
+            if (writeLock.try_lock()) {
+                // Наша операция опубликована до захвата, поэтому выполнится в этом пакете
+                combine();
+                writeLock.unlock();
+                break;
+            }
+            this_thread::yield();
+        }
+
+        bool result = slot.result;
+        slot.state.store(EMPTY, memory_order_relaxed);
+        return result;
+    }
+
+    // Оптимистичный спуск; false, если спуск нужно повторить
+    bool tryFind(int key, bool& found, int& value) const {
+        uint64_t seq = sequence.load(memory_order_acquire);
+        if (seq & 1) return false;
+
+        found = false;
+        CRBNode* node = root.load(memory_order_acquire);
+        for (int steps = 0; node != nil; ++steps) {
+            if (steps == MAX_STEPS) return false; // Несогласованное состояние
+            if (key == node->key) {
+                found = true;
+                value = node->value.load(memory_order_relaxed);
+                break;
+            }
+            node = key < node->key ? node->left.load(memory_order_acquire)
+                                   : node->right.load(memory_order_acquire);
+        }
+
+        atomic_thread_fence(memory_order_acquire);
+        return sequence.load(memory_order_relaxed) == seq;
+    }
+
+    // Защита узлов от освобождения на время чтения
+    class EpochGuard {
+    private:
+        atomic<uint64_t>& local;
+
+    public:
+        EpochGuard(ConcurrentRedBlackTree& tree) : local(tree.readers[ThreadRegistry::index()].epoch) {
+            local.store(tree.globalEpoch.load(memory_order_acquire), memory_order_relaxed);
+            atomic_thread_fence(memory_order_seq_cst);
+        }
+
+        ~EpochGuard() {
+            local.store(0, memory_order_release);
+        }
+    };
+
+    // Проверка свойств RB-дерева; возвращает чёрную высоту или -1
+    int checkNode(CRBNode* node, long long lo, long long hi) const {
+        if (node == nil) return 1;
+        if (node->key <= lo || node->key >= hi) return -1;
+        if (node->color == RED && (left(node)->color == RED || right(node)->color == RED)) return -1;
+        int leftHeight = checkNode(left(node), lo, node->key);
+        int rightHeight = checkNode(right(node), node->key, hi);
+        if (leftHeight < 0 || leftHeight != rightHeight) return -1;
+        return leftHeight + (node->color == BLACK ? 1 : 0);
+    }
+
+    void destroy(CRBNode* node) {
+        if (node == nil) return;
+        destroy(left(node));
+        destroy(right(node));
+        delete node;
+    }
+
+public:
+    ConcurrentRedBlackTree() : sequence(0), count(0), globalEpoch(1), retired{nullptr, nullptr, nullptr} {
+        nil = new CRBNode(0, 0);
+        nil->color = BLACK;
+        nil->left.store(nil);
+        nil->right.store(nil);
+        root.store(nil);
+    }
+
+    ConcurrentRedBlackTree(const ConcurrentRedBlackTree&) = delete;
+    ConcurrentRedBlackTree& operator=(const ConcurrentRedBlackTree&) = delete;
+
+    // Вызывается, когда дерево больше никто не использует
+    ~ConcurrentRedBlackTree() {
+        destroy(getRoot());
+        for (CRBNode*& list : retired) {
+            freeList(list);
+        }
+        delete nil;
+    }
+
+    // Вставка или обновление; true, если ключа не было
+    bool insert(int key, int value) {
+        return write(INSERT, key, value);
+    }
+
+    // Удаление; true, если ключ был
+    bool remove(int key) {
+        return write(REMOVE, key, 0);
+    }
+
+    // Поиск без блокировок; после серии неудачных проверок - под мьютексом
+    bool find(int key, int& value) {
+        EpochGuard guard(*this);
+        bool found;
+        for (int attempt = 0; attempt < OPTIMISTIC_ATTEMPTS; ++attempt) {
+            if (tryFind(key, found, value)) return found;
+        }
+        lock_guard<mutex> lock(writeLock);
+        CRBNode* node = search(key);
+        if (node == nil) return false;
+        value = node->value.load(memory_order_relaxed);
+        return true;
+    }
+
+    bool contains(int key) {
+        int value;
+        return find(key, value);
+    }
+
+    // Количество элементов (точное, когда нет одновременных писателей)
+    size_t size() {
+        lock_guard<mutex> lock(writeLock);
+        return count;
+    }
+
+    // Проверка упорядоченности и свойств RB-дерева (без одновременных писателей)
+    bool isValid() {
+        lock_guard<mutex> lock(writeLock);
+        CRBNode* top = getRoot();
+        return top->color == BLACK && checkNode(top, LLONG_MIN, LLONG_MAX) > 0;
+    }
+};
+
+// Обычное красно-чёрное дерево (как RedBlackTree в dop_RBTree.) с
+// отображением int -> int и без какой-либо синхронизации: обычные указатели,
+// ни счётчика версий, ни слотов писателей, ни эпох
+class SequentialRedBlackTree {
+private:
+    struct Node {
+        int key;
+        int value;
+        Node* left;
+        Node* right;
+        Node* parent;
+        Color color;
+
+        Node(int k, int v, Node* nil) : key(k), value(v), left(nil), right(nil), parent(nil), color(RED) {}
+    };
+
+    Node* root;
+    Node* nil;
+
+    void leftRotate(Node* x) {
+        Node* y = x->right;
+        x->right = y->left;
+        if (y->left != nil) y->left->parent = x;
+        y->parent = x->parent;
+        if (x->parent == nil) {
+            root = y;
+        } else if (x == x->parent->left) {
+            x->parent->left = y;
+        } else {
+            x->parent->right = y;
+        }
+        y->left = x;
+        x->parent = y;
+    }
+
+    void rightRotate(Node* y) {
+        Node* x = y->left;
+        y->left = x->right;
+        if (x->right != nil) x->right->parent = y;
+        x->parent = y->parent;
+        if (y->parent == nil) {
+            root = x;
+        } else if (y == y->parent->right) {
+            y->parent->right = x;
+        } else {
+            y->parent->left = x;
+        }
+        x->right = y;
+        y->parent = x;
+    }
+
+    void insertFixup(Node* z) {
+        while (z->parent->color == RED) {
+            Node* grand = z->parent->parent;
+            bool parentIsLeft = z->parent == grand->left;
+            Node* uncle = parentIsLeft ? grand->right : grand->left;
+            if (uncle->color == RED) {
+                z->parent->color = BLACK;
+                uncle->color = BLACK;
+                grand->color = RED;
+                z = grand;
+            } else {
+                if (parentIsLeft && z == z->parent->right) {
+                    z = z->parent;
+                    leftRotate(z);
+                } else if (!parentIsLeft && z == z->parent->left) {
+                    z = z->parent;
+                    rightRotate(z);
+                }
+                z->parent->color = BLACK;
+                z->parent->parent->color = RED;
+                if (parentIsLeft) {
+                    rightRotate(z->parent->parent);
+                } else {
+                    leftRotate(z->parent->parent);
+                }
+            }
+        }
+        root->color = BLACK;
+    }
+
+    void transplant(Node* u, Node* v) {
+        if (u->parent == nil) {
+            root = v;
+        } else if (u == u->parent->left) {
+            u->parent->left = v;
+        } else {
+            u->parent->right = v;
+        }
+        v->parent = u->parent;
+    }
+
+    void deleteFixup(Node* x) {
+        while (x != root && x->color == BLACK) {
+            bool isLeft = x == x->parent->left;
+            Node* w = isLeft ? x->parent->right : x->parent->left;
+            if (w->color == RED) {
+                w->color = BLACK;
+                x->parent->color = RED;
+                if (isLeft) leftRotate(x->parent); else rightRotate(x->parent);
+                w = isLeft ? x->parent->right : x->parent->left;
+            }
+            Node* nearChild = isLeft ? w->left : w->right;
+            Node* farChild = isLeft ? w->right : w->left;
+            if (nearChild->color == BLACK && farChild->color == BLACK) {
+                w->color = RED;
+                x = x->parent;
+            } else {
+                if (farChild->color == BLACK) {
+                    nearChild->color = BLACK;
+                    w->color = RED;
+                    if (isLeft) rightRotate(w); else leftRotate(w);
+                    w = isLeft ? x->parent->right : x->parent->left;
+                }
+                w->color = x->parent->color;
+                x->parent->color = BLACK;
+                (isLeft ? w->right : w->left)->color = BLACK;
+                if (isLeft) leftRotate(x->parent); else rightRotate(x->parent);
+                x = root;
+            }
+        }
+        x->color = BLACK;
+    }
+
+    Node* search(int key) const {
+        Node* node = root;
+        while (node != nil && node->key != key) {
+            node = key < node->key ? node->left : node->right;
+        }
+        return node;
+    }
+
+    int checkNode(Node* node, long long lo, long long hi) const {
+        if (node == nil) return 1;
+        if (node->key <= lo || node->key >= hi) return -1;
+        if (node->color == RED && (node->left->color == RED || node->right->color == RED)) return -1;
+        int leftHeight = checkNode(node->left, lo, node->key);
+        int rightHeight = checkNode(node->right, node->key, hi);
+        if (leftHeight < 0 || leftHeight != rightHeight) return -1;
+        return leftHeight + (node->color == BLACK ? 1 : 0);
+    }
+
+    void destroy(Node* node) {
+        if (node == nil) return;
+        destroy(node->left);
+        destroy(node->right);
+        delete node;
+    }
+
+public:
+    SequentialRedBlackTree() {
+        nil = new Node(0, 0, nullptr);
+        nil->color = BLACK;
+        nil->left = nil->right = nil->parent = nil;
+        root = nil;
+    }
+
+    SequentialRedBlackTree(const SequentialRedBlackTree&) = delete;
+    SequentialRedBlackTree& operator=(const SequentialRedBlackTree&) = delete;
+
+    ~SequentialRedBlackTree() {
+        destroy(root);
+        delete nil;
+    }
+
+    // Вставка или обновление; true, если ключа не было
+    bool insert(int key, int value) {
+        Node* y = nil;
+        Node* x = root;
+        while (x != nil) {
+            if (key == x->key) {
+                x->value = value;
+                return false;
+            }
+            y = x;
+            x = key < x->key ? x->left : x->right;
+        }
+        Node* z = new Node(key, value, nil);
+        z->parent = y;
+        if (y == nil) {
+            root = z;
+        } else if (key < y->key) {
+            y->left = z;
+        } else {
+            y->right = z;
+        }
+        insertFixup(z);
+        return true;
+    }
+
+    // Удаление; true, если ключ был
+    bool remove(int key) {
+        Node* z = search(key);
+        if (z == nil) return false;
+
+        Node* y = z;
+        Node* x;
+        Color yOriginalColor = y->color;
+        if (z->left == nil) {
+            x = z->right;
+            transplant(z, z->right);
+        } else if (z->right == nil) {
+            x = z->left;
+            transplant(z, z->left);
+        } else {
+            y = z->right;
+            while (y->left != nil) y = y->left;
+            yOriginalColor = y->color;
+            x = y->right;
+            if (y->parent == z) {
+                x->parent = y;
+            } else {
+                transplant(y, y->right);
+                y->right = z->right;
+                y->right->parent = y;
+            }
+            transplant(z, y);
+            y->left = z->left;
+            y->left->parent = y;
+            y->color = z->color;
+        }
+        if (yOriginalColor == BLACK) {
+            deleteFixup(x);
+        }
+        delete z;
+        return true;
+    }
+
+    bool contains(int key) const {
+        return search(key) != nil;
+    }
+
+    bool isValid() const {
+        return root->color == BLACK && checkNode(root, LLONG_MIN, LLONG_MAX) > 0;
+    }
+};
+
+// Эталон: обычное последовательное дерево, все операции под одним мьютексом
+class GlobalLockRedBlackTree {
+private:
+    SequentialRedBlackTree tree;
+    mutex lock;
+
+public:
+    bool insert(int key, int value) {
+        lock_guard<mutex> guard(lock);
+        return tree.insert(key, value);
+    }
+
+    bool remove(int key) {
+        lock_guard<mutex> guard(lock);
+        return tree.remove(key);
+    }
+
+    bool contains(int key) {
+        lock_guard<mutex> guard(lock);
+        return tree.contains(key);
+    }
+
+    bool isValid() {
+        lock_guard<mutex> guard(lock);
+        return tree.isValid();
+    }
+};
+
+// Узел списка с пропусками: height ссылок next лежат в той же памяти сразу
+// за узлом. Младший бит ссылки - метка логического удаления узла на этом уровне
+struct SkipNode {
+    const int key;
+    atomic<int> value;
+    const int height;
+    SkipNode* nextRetired; // Список узлов, ожидающих освобождения
+
+    atomic<uintptr_t>& next(int level) {
+        return reinterpret_cast<atomic<uintptr_t>*>(this + 1)[level];
+    }
+
+    static SkipNode* create(int key, int value, int height) {
+        void* memory = ::operator new(sizeof(SkipNode) + height * sizeof(atomic<uintptr_t>));
+        SkipNode* node = new (memory) SkipNode(key, value, height);
+        for (int level = 0; level < height; ++level) {
+            new (&node->next(level)) atomic<uintptr_t>(0);
+        }
+        return node;
+    }
+
+    static void destroy(SkipNode* node) {
+        node->~SkipNode();
+        ::operator delete(node);
+    }
+
+private:
+    SkipNode(int k, int v, int h) : key(k), value(v), height(h), nextRetired(nullptr) {}
+};
+
+// Список с пропусками без блокировок (отображение int -> int, схема Харриса
+// и Фрейзера). Удаляемый узел помечается на всех уровнях сверху вниз, удаление
+// выполняет поток, пометивший нижний уровень; вырезают помеченные узлы все,
+// кто проходит мимо. Высота нового узла берётся из генератора своего потока.
+// Удалённые узлы копятся в списках своего потока по эпохам и освобождаются,
+// когда ни один поток уже не может их видеть.
+class ConcurrentSkipList {
+private:
+    static const int MAX_LEVEL = 24;       // Хватает на 2^24 ключей при p = 1/2
+    static const int ADVANCE_PERIOD = 64;  // Удалений между попытками сменить эпоху
+
+    // Эпоха потока (0 - вне списка) и его отложенные узлы по эпохам удаления
+    struct alignas(64) ThreadState {
+        atomic<uint64_t> epoch{0};
+        SkipNode* retired[3] = {nullptr, nullptr, nullptr};
+        uint64_t retiredEpoch[3] = {0, 0, 0};
+        int sinceAdvance = 0;
+    };
+
+    SkipNode* head;
+    atomic<long long> count;
+    atomic<uint64_t> globalEpoch;
+    ThreadState states[ThreadRegistry::MAX_THREADS];
+
+    static bool isMarked(uintptr_t link) { return link & 1; }
+    static SkipNode* pointer(uintptr_t link) { return reinterpret_cast<SkipNode*>(link & ~static_cast<uintptr_t>(1)); }
+    static uintptr_t word(SkipNode* node) { return reinterpret_cast<uintptr_t>(node); }
+
+    // Высота с распределением P(h) = 2^-h; у каждого потока свой генератор
+    static int randomHeight() {
+        thread_local mt19937 gen(random_device{}());
+        uint32_t bits = static_cast<uint32_t>(gen()) | (1u << (MAX_LEVEL - 1));
+        return __builtin_ctz(bits) + 1;
+    }
+
+    // Спуск с вырезанием помеченных узлов: на каждом уровне preds - последний
+    // узел с ключом меньше key, succs - следующий за ним. false, если другой
+    // поток изменил ссылку и спуск нужно повторить
+    bool tryLocate(int key, SkipNode** preds, SkipNode** succs) {
+        SkipNode* pred = head;
+        for (int level = MAX_LEVEL - 1; level >= 0; --level) {
+            SkipNode* curr = pointer(pred->next(level).load(memory_order_acquire));
+            while (curr) {
+                uintptr_t succ = curr->next(level).load(memory_order_acquire);
+                if (isMarked(succ)) {
+                    uintptr_t expected = word(curr);
+                    if (!pred->next(level).compare_exchange_strong(expected, word(pointer(succ)))) {
+                        return false;
+                    }
+                    curr = pointer(succ);
+                    continue;
+                }
+                if (curr->key >= key) break;
+                pred = curr;
+                curr = pointer(succ);
+            }
+            preds[level] = pred;
+            succs[level] = curr;
+        }
+        return true;
+    }
+
+    // true, если ключ есть (узел - succs[0])
+    bool locate(int key, SkipNode** preds, SkipNode** succs) {
+        while (!tryLocate(key, preds, succs)) {}
+        return succs[0] && succs[0]->key == key;
+    }
+
+    // Первый непомеченный узел нижнего уровня с ключом не меньше key; только чтение
+    SkipNode* lowerBound(int key) {
+        SkipNode* pred = head;
+        SkipNode* curr = nullptr;
+        for (int level = MAX_LEVEL - 1; level >= 0; --level) {
+            curr = pointer(pred->next(level).load(memory_order_acquire));
+            while (curr) {
+                uintptr_t succ = curr->next(level).load(memory_order_acquire);
+                if (!isMarked(succ)) {
+                    if (curr->key >= key) break;
+                    pred = curr;
+                }
+                curr = pointer(succ);
+            }
+        }
+        return curr;
+    }
+
+    // Подвешивание вставленного узла на верхние уровни. Если узел тем временем
+    // начали удалять, достройка прекращается, а ссылки, поставленные на него
+    // после вырезания, убирает повторный спуск
+    void linkUpperLevels(SkipNode* node, SkipNode** preds, SkipNode** succs) {
+        bool linking = true;
+        for (int level = 1; level < node->height && linking; ++level) {
+            while (true) {
+                // Пока узел не подвешен на этом уровне, его ссылку меняет только
+                // удаляющий поток, ставя метку
+                uintptr_t link = node->next(level).load(memory_order_acquire);
+                if (isMarked(link) || (pointer(link) != succs[level] &&
+                                       !node->next(level).compare_exchange_strong(link, word(succs[level])))) {
+                    linking = false;
+                    break;
+                }
+                uintptr_t expected = word(succs[level]);
+                if (preds[level]->next(level).compare_exchange_strong(expected, word(node))) break;
+                locate(node->key, preds, succs);
+                if (succs[0] != node) {
+                    linking = false; // Узел уже вырезан с нижнего уровня
+                    break;
+                }
+            }
+        }
+        // Пара к барьеру в remove: либо удаляющий увидит наши ссылки при своём
+        // спуске, либо мы увидим метку и вырежем узел сами
+        atomic_thread_fence(memory_order_seq_cst);
+        if (isMarked(node->next(0).load(memory_order_relaxed))) {
+            locate(node->key, preds, succs);
+        }
+    }
+
+    void freeList(SkipNode*& list) {
+        while (list) {
+            SkipNode* next = list->nextRetired;
+            SkipNode::destroy(list);
+            list = next;
+        }
+    }
+
+    // Переход к следующей эпохе, если все потоки внутри списка уже в текущей
+    void tryAdvanceEpoch() {
+        atomic_thread_fence(memory_order_seq_cst);
+        uint64_t current = globalEpoch.load(memory_order_relaxed);
+        int high = ThreadRegistry::highWater();
+        for (int i = 0; i < high; ++i) {
+            uint64_t local = states[i].epoch.load(memory_order_acquire);
+            if (local != 0 && local != current) return;
+        }
+        globalEpoch.compare_exchange_strong(current, current + 1);
+    }
+
+    // Узел, вырезанный в эпохе e, могут видеть только потоки, вошедшие не позже
+    // e, поэтому с эпохи e + 2 его можно освободить. Список с тем же номером
+    // e % 3 хранит узлы эпохи не позже e - 3 и освобождается при повторном использовании
+    void retire(SkipNode* node) {
+        ThreadState& state = states[ThreadRegistry::index()];
+        uint64_t epoch = globalEpoch.load(memory_order_seq_cst);
+        int slot = static_cast<int>(epoch % 3);
+        if (state.retiredEpoch[slot] != epoch) {
+            freeList(state.retired[slot]);
+            state.retiredEpoch[slot] = epoch;
+        }
+        node->nextRetired = state.retired[slot];
+        state.retired[slot] = node;
+        if (++state.sinceAdvance >= ADVANCE_PERIOD) {
+            state.sinceAdvance = 0;
+            tryAdvanceEpoch();
+        }
+    }
+
+    // Защита узлов от освобождения на время операции
+    class EpochGuard {
+    private:
+        atomic<uint64_t>& local;
+
+    public:
+        EpochGuard(ConcurrentSkipList& list) : local(list.states[ThreadRegistry::index()].epoch) {
+            local.store(list.globalEpoch.load(memory_order_acquire), memory_order_relaxed);
+            atomic_thread_fence(memory_order_seq_cst);
+        }
+
+        ~EpochGuard() {
+            local.store(0, memory_order_release);
+        }
+    };
+
+public:
+    ConcurrentSkipList() : count(0), globalEpoch(1) {
+        head = SkipNode::create(INT_MIN, 0, MAX_LEVEL);
+    }
+
+    ConcurrentSkipList(const ConcurrentSkipList&) = delete;
+    ConcurrentSkipList& operator=(const ConcurrentSkipList&) = delete;
+
+    // Вызывается, когда список больше никто не использует
+    ~ConcurrentSkipList() {
+        SkipNode* node = pointer(head->next(0).load());
+        while (node) {
+            SkipNode* next = pointer(node->next(0).load());
+            SkipNode::destroy(node);
+            node = next;
+        }
+        for (ThreadState& state : states) {
+            for (SkipNode*& list : state.retired) {
+                freeList(list);
+            }
+        }
+        SkipNode::destroy(head);
+    }
+
+    // Вставка или обновление; true, если ключа не было
+    bool insert(int key, int value) {
+        EpochGuard guard(*this);
+        SkipNode* preds[MAX_LEVEL];
+        SkipNode* succs[MAX_LEVEL];
+        SkipNode* node = nullptr;
+        while (true) {
+            if (locate(key, preds, succs)) {
+                succs[0]->value.store(value, memory_order_relaxed);
+                if (node) SkipNode::destroy(node); // Так и не был опубликован
+                return false;
+            }
+            if (!node) node = SkipNode::create(key, value, randomHeight());
+            for (int level = 0; level < node->height; ++level) {
+                node->next(level).store(word(succs[level]), memory_order_relaxed);
+            }
+            // Узел существует с момента появления на нижнем уровне
+            uintptr_t expected = word(succs[0]);
+            if (preds[0]->next(0).compare_exchange_strong(expected, word(node))) break;
+        }
+        count.fetch_add(1, memory_order_relaxed);
+        linkUpperLevels(node, preds, succs);
+        return true;
+    }
+
+    // Удаление; true, если ключ был и удалил его этот поток
+    bool remove(int key) {
+        EpochGuard guard(*this);
+        SkipNode* preds[MAX_LEVEL];
+        SkipNode* succs[MAX_LEVEL];
+        if (!locate(key, preds, succs)) return false;
+
+        SkipNode* victim = succs[0];
+        for (int level = victim->height - 1; level >= 1; --level) {
+            uintptr_t link = victim->next(level).load(memory_order_acquire);
+            while (!isMarked(link) && !victim->next(level).compare_exchange_weak(link, link | 1)) {}
+        }
+        uintptr_t link = victim->next(0).load(memory_order_acquire);
+        while (true) {
+            if (isMarked(link)) return false; // Удалил другой поток
+            if (victim->next(0).compare_exchange_weak(link, link | 1)) break;
+        }
+        atomic_thread_fence(memory_order_seq_cst);
+
+        count.fetch_sub(1, memory_order_relaxed);
+        locate(key, preds, succs); // Вырезание со всех уровней
+        retire(victim);
+        return true;
+    }
+
+    // Поиск без блокировок и без записи в общую память
+    bool find(int key, int& value) {
+        EpochGuard guard(*this);
+        SkipNode* node = lowerBound(key);
+        if (!node || node->key != key) return false;
+        value = node->value.load(memory_order_relaxed);
+        return true;
+    }
+
+    bool contains(int key) {
+        int value;
+        return find(key, value);
+    }
+
+    // Пары (ключ, значение) с lo <= key <= hi по возрастанию ключей. Обход не
+    // атомарен: ключ, вставленный или удалённый во время обхода, может как
+    // попасть в результат, так и нет
+    void range(int lo, int hi, vector<pair<int, int>>& out) {
+        out.clear();
+        EpochGuard guard(*this);
+        SkipNode* node = lowerBound(lo);
+        while (node && node->key <= hi) {
+            uintptr_t succ = node->next(0).load(memory_order_acquire);
+            if (!isMarked(succ)) {
+                out.push_back({node->key, node->value.load(memory_order_relaxed)});
+            }
+            node = pointer(succ);
+        }
+    }
+
+    // Количество элементов (точное, когда нет одновременных писателей)
+    size_t size() const {
+        return static_cast<size_t>(count.load(memory_order_relaxed));
+    }
+
+    // Проверка упорядоченности уровней и отсутствия помеченных узлов
+    // (без одновременных писателей)
+    bool isValid() {
+        for (int level = 0; level < MAX_LEVEL; ++level) {
+            long long nodes = 0;
+            uintptr_t link = head->next(level).load();
+            while (pointer(link)) {
+                SkipNode* node = pointer(link);
+                link = node->next(level).load();
+                if (isMarked(link) || node->height <= level) return false;
+                if (pointer(link) && pointer(link)->key <= node->key) return false;
+                ++nodes;
+            }
+            if (level == 0 && nodes != count.load()) return false;
+        }
+        return true;
+    }
+};
+
+// Смешанная нагрузка: каждый поток выполняет OPERATIONS операций,
+// доля чтений readPercent, остальное поровну вставки и удаления
+template <typename TreeType>
+double runMixedWorkload(int threads, int readPercent, int keyRange, int operations) {
+    TreeType tree;
+    mt19937 fillGen(12345);
+    for (int i = 0; i < keyRange / 2; ++i) {
+        tree.insert(fillGen() % keyRange, i);
+    }
+
+    atomic<int> ready(0);
+    atomic<bool> start(false);
+    vector<thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            mt19937 gen(1000 + t); // Свой генератор у каждого потока
+            ready.fetch_add(1);
+            while (!start.load(memory_order_acquire)) this_thread::yield();
+
+            size_t hits = 0;
+            for (int j = 0; j < operations; ++j) {
+                int key = gen() % keyRange;
+                int dice = gen() % 100;
+                if (dice < readPercent) {
+                    hits += tree.contains(key);
+                } else if (dice % 2 == 0) {
+                    tree.insert(key, j);
+                } else {
+                    tree.remove(key);
+                }
+            }
+            volatile size_t sink = hits;
+            (void)sink;
+        });
+    }
+
+    while (ready.load() < threads) this_thread::yield();
+    auto begin = high_resolution_clock::now();
+    start.store(true, memory_order_release);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    auto end = high_resolution_clock::now();
+
+    if (!tree.isValid()) {
+        throw logic_error("Ordered map invariants violated after concurrent run");
+    }
+
+    double seconds = duration_cast<microseconds>(end - begin).count() / 1e6;
+    return threads * static_cast<double>(operations) / seconds / 1e6; // Миллионов операций в секунду
+}
+
+// Пропускная способность в зависимости от числа потоков и доли чтений:
+// дерево под глобальным мьютексом, оптимистичное дерево и список с пропусками
+void testConcurrentRedBlackTree() {
+    const int KEY_RANGE = 1 << 17;
+    const int OPERATIONS = 200000;
+    const int readPercents[] = {50, 90, 99, 100};
+
+    int maxThreads = max(4, static_cast<int>(thread::hardware_concurrency()));
+    maxThreads = min(maxThreads, ThreadRegistry::MAX_THREADS - 1);
+
+    ofstream csv("concurrent_rb_results.csv");
+    csv << "Threads,ReadPercent,GlobalLock_Mops,Optimistic_Mops,SkipList_Mops\n";
+
+    for (int readPercent : readPercents) {
+        for (int threads = 1; threads <= maxThreads; threads *= 2) {
+            double locked = runMixedWorkload<GlobalLockRedBlackTree>(threads, readPercent, KEY_RANGE, OPERATIONS);
+            double optimistic = runMixedWorkload<ConcurrentRedBlackTree>(threads, readPercent, KEY_RANGE, OPERATIONS);
+            double skipList = runMixedWorkload<ConcurrentSkipList>(threads, readPercent, KEY_RANGE, OPERATIONS);
+
+            cout << "Threads: " << threads << ", reads: " << readPercent << "%"
+                 << " - global lock: " << locked << " Mops/s"
+                 << ", optimistic: " << optimistic << " Mops/s"
+                 << ", skip list: " << skipList << " Mops/s" << endl;
+            csv << threads << "," << readPercent << "," << locked << "," << optimistic << "," << skipList << "\n";
+        }
+    }
+
+    cout << "Throughput data saved to concurrent_rb_results.csv" << endl;
+}
+
+int main() {
+    try {
+        testConcurrentRedBlackTree();
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
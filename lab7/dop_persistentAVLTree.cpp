@@ -0,0 +1,480 @@
+/*
+10) Персистентное AVL-дерево с копированием пути: каждая вставка и удаление
+    возвращают новую версию, старые версии (снимки) остаются неизменными.
+    Сравнение накладных расходов с обычным (изменяемым) AVL-деревом.
+ */
+
+// реализация персистентного AVL-дерева
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <climits>
+#include <fstream>
+#include <atomic>
+#include <numeric>
+
+using namespace std;
+using namespace std::chrono;
+
+// Узел AVL-дерева
+struct AVLNode {
+    int key;
+    AVLNode* left;
+    AVLNode* right;
+    int height;
+
+    AVLNode(int k) : key(k), left(nullptr), right(nullptr), height(1) {}
+};
+
+// Обычное AVL-дерево (для сравнения)
+class AVLTree {
+private:
+    AVLNode* root;
+
+    int getHeight(AVLNode* node) const {
+        return node ? node->height : 0;
+    }
+
+    void updateHeight(AVLNode* node) {
+        if (node) {
+            node->height = 1 + max(getHeight(node->left), getHeight(node->right));
+        }
+    }
+
+    int getBalance(AVLNode* node) const {
+        return node ? getHeight(node->left) - getHeight(node->right) : 0;
+    }
+
+    AVLNode* rotateRight(AVLNode* y) {
+        AVLNode* x = y->left;
+        y->left = x->right;
+        x->right = y;
+        updateHeight(y);
+        updateHeight(x);
+        return x;
+    }
+
+    AVLNode* rotateLeft(AVLNode* x) {
+        AVLNode* y = x->right;
+        x->right = y->left;
+        y->left = x;
+        updateHeight(x);
+        updateHeight(y);
+        return y;
+    }
+
+    AVLNode* balance(AVLNode* node) {
+        updateHeight(node);
+        int balanceFactor = getBalance(node);
+
+        if (balanceFactor > 1) {
+            if (getBalance(node->left) < 0) {
+                node->left = rotateLeft(node->left);
+            }
+            return rotateRight(node);
+        }
+        if (balanceFactor < -1) {
+            if (getBalance(node->right) > 0) {
+                node->right = rotateRight(node->right);
+            }
+            return rotateLeft(node);
+        }
+        return node;
+    }
+
+    AVLNode* insert(AVLNode* node, int key) {
+        if (!node) return new AVLNode(key);
+
+        if (key < node->key) {
+            node->left = insert(node->left, key);
+        } else if (key > node->key) {
+            node->right = insert(node->right, key);
+        } else {
+            return node; // Дубликаты не допускаются
+        }
+
+        return balance(node);
+    }
+
+    AVLNode* findMin(AVLNode* node) const {
+        while (node && node->left) {
+            node = node->left;
+        }
+        return node;
+    }
+
+    AVLNode* remove(AVLNode* node, int key) {
+        if (!node) return nullptr;
+
+        if (key < node->key) {
+            node->left = remove(node->left, key);
+        } else if (key > node->key) {
+            node->right = remove(node->right, key);
+        } else {
+            if (!node->left || !node->right) {
+                AVLNode* child = node->left ? node->left : node->right;
+                delete node;
+                return child;
+            }
+            AVLNode* temp = findMin(node->right);
+            node->key = temp->key;
+            node->right = remove(node->right, temp->key);
+        }
+
+        return balance(node);
+    }
+
+    // Поузловое копирование поддерева
+    static AVLNode* copy(const AVLNode* node) {
+        if (!node) return nullptr;
+        AVLNode* result = new AVLNode(node->key);
+        result->height = node->height;
+        result->left = copy(node->left);
+        result->right = copy(node->right);
+        return result;
+    }
+
+    static void destroy(AVLNode* node) {
+        if (!node) return;
+        destroy(node->left);
+        destroy(node->right);
+        delete node;
+    }
+
+public:
+    AVLTree() : root(nullptr) {}
+    AVLTree(const AVLTree& other) : root(copy(other.root)) {}
+    AVLTree& operator=(const AVLTree&) = delete;
+    ~AVLTree() { destroy(root); }
+
+    void insert(int key) {
+        root = insert(root, key);
+    }
+
+    void remove(int key) {
+        root = remove(root, key);
+    }
+
+    bool contains(int key) const {
+        AVLNode* node = root;
+        while (node && node->key != key) {
+            node = key < node->key ? node->left : node->right;
+        }
+        return node != nullptr;
+    }
+};
+
+// Неизменяемый узел персистентного дерева. Узел может входить в несколько
+// версий сразу, поэтому освобождается по счётчику ссылок.
+struct PersistentNode {
+    const int key;
+    const PersistentNode* const left;
+    const PersistentNode* const right;
+    const int height;
+    mutable atomic<int> refs;
+
+    static atomic<long long> liveNodes; // Число существующих узлов (для замеров памяти)
+
+    PersistentNode(int k, const PersistentNode* l, const PersistentNode* r)
+        : key(k), left(l), right(r),
+          height(1 + max(l ? l->height : 0, r ? r->height : 0)), refs(1) {
+        liveNodes.fetch_add(1, memory_order_relaxed);
+    }
+
+    ~PersistentNode() {
+        liveNodes.fetch_sub(1, memory_order_relaxed);
+    }
+};
+
+atomic<long long> PersistentNode::liveNodes(0);
+
+// Персистентное AVL-дерево. Вставка и удаление копируют только путь от корня
+// (O(log n) новых узлов), остальные поддеревья разделяются со старой версией.
+// Копия дерева - снимок за O(1); счётчики ссылок атомарны, поэтому снимки
+// можно читать и освобождать из других потоков.
+class PersistentAVLTree {
+private:
+    typedef const PersistentNode* NodePtr;
+
+    NodePtr root;
+    size_t count;
+
+    PersistentAVLTree(NodePtr root, size_t count) : root(root), count(count) {}
+
+    static int getHeight(NodePtr node) {
+        return node ? node->height : 0;
+    }
+
+    static NodePtr retain(NodePtr node) {
+        if (node) node->refs.fetch_add(1, memory_order_relaxed);
+        return node;
+    }
+
+    static void release(NodePtr node) {
+        if (node && node->refs.fetch_sub(1, memory_order_acq_rel) == 1) {
+            release(node->left);
+            release(node->right);
+            delete node;
+        }
+    }
+
+    // Новый узел над поддеревьями left и right (ссылки на них передаются узлу)
+    // с восстановлением баланса; повороты строят новые узлы вместо изменения старых
+    static NodePtr balance(int key, NodePtr left, NodePtr right) {
+        int balanceFactor = getHeight(left) - getHeight(right);
+
+        if (balanceFactor > 1) {
+            NodePtr result;
+            if (getHeight(left->left) >= getHeight(left->right)) {
+                // Лево-левый случай
+                result = new PersistentNode(left->key, retain(left->left),
+                                            new PersistentNode(key, retain(left->right), right));
+            } else {
+                // Лево-правый случай
+                NodePtr middle = left->right;
+                result = new PersistentNode(middle->key,
+                                            new PersistentNode(left->key, retain(left->left), retain(middle->left)),
+                                            new PersistentNode(key, retain(middle->right), right));
+            }
+            release(left);
+            return result;
+        }
+
+        if (balanceFactor < -1) {
+            NodePtr result;
+            if (getHeight(right->right) >= getHeight(right->left)) {
+                // Право-правый случай
+                result = new PersistentNode(right->key,
+                                            new PersistentNode(key, left, retain(right->left)),
+                                            retain(right->right));
+            } else {
+                // Право-левый случай
+                NodePtr middle = right->left;
+                result = new PersistentNode(middle->key,
+                                            new PersistentNode(key, left, retain(middle->left)),
+                                            new PersistentNode(right->key, retain(middle->right), retain(right->right)));
+            }
+            release(right);
+            return result;
+        }
+
+        return new PersistentNode(key, left, right);
+    }
+
+    // Вставка отсутствующего ключа; возвращает новую ссылку на корень поддерева
+    static NodePtr insert(NodePtr node, int key) {
+        if (!node) return new PersistentNode(key, nullptr, nullptr);
+
+        if (key < node->key) {
+            return balance(node->key, insert(node->left, key), retain(node->right));
+        }
+        return balance(node->key, retain(node->left), insert(node->right, key));
+    }
+
+    // Удаление присутствующего ключа
+    static NodePtr remove(NodePtr node, int key) {
+        if (key < node->key) {
+            return balance(node->key, remove(node->left, key), retain(node->right));
+        }
+        if (key > node->key) {
+            return balance(node->key, retain(node->left), remove(node->right, key));
+        }
+
+        if (!node->left) return retain(node->right);
+        if (!node->right) return retain(node->left);
+
+        // Замена минимальным ключом правого поддерева
+        NodePtr successor = node->right;
+        while (successor->left) {
+            successor = successor->left;
+        }
+        return balance(successor->key, retain(node->left), remove(node->right, successor->key));
+    }
+
+    static int maxDepth(NodePtr node) {
+        if (!node) return 0;
+        return 1 + max(maxDepth(node->left), maxDepth(node->right));
+    }
+
+    static bool isBalanced(NodePtr node, long long lo, long long hi) {
+        if (!node) return true;
+        if (node->key <= lo || node->key >= hi) return false;
+        if (abs(getHeight(node->left) - getHeight(node->right)) > 1) return false;
+        if (node->height != 1 + max(getHeight(node->left), getHeight(node->right))) return false;
+        return isBalanced(node->left, lo, node->key) && isBalanced(node->right, node->key, hi);
+    }
+
+public:
+    PersistentAVLTree() : root(nullptr), count(0) {}
+
+    // Снимок: копия разделяет все узлы, O(1)
+    PersistentAVLTree(const PersistentAVLTree& other) : root(retain(other.root)), count(other.count) {}
+
+    PersistentAVLTree(PersistentAVLTree&& other) noexcept : root(other.root), count(other.count) {
+        other.root = nullptr;
+        other.count = 0;
+    }
+
+    PersistentAVLTree& operator=(PersistentAVLTree other) noexcept {
+        swap(root, other.root);
+        swap(count, other.count);
+        return *this;
+    }
+
+    ~PersistentAVLTree() {
+        release(root);
+    }
+
+    // Новая версия с ключом key; исходная версия не меняется
+    PersistentAVLTree insert(int key) const {
+        if (contains(key)) return *this;
+        return PersistentAVLTree(insert(root, key), count + 1);
+    }
+
+    // Новая версия без ключа key
+    PersistentAVLTree remove(int key) const {
+        if (!contains(key)) return *this;
+        return PersistentAVLTree(remove(root, key), count - 1);
+    }
+
+    bool contains(int key) const {
+        NodePtr node = root;
+        while (node && node->key != key) {
+            node = key < node->key ? node->left : node->right;
+        }
+        return node != nullptr;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    int getMaxDepth() const {
+        return maxDepth(root);
+    }
+
+    bool isValid() const {
+        return isBalanced(root, LLONG_MIN, LLONG_MAX);
+    }
+};
+
+// Сравнение персистентного и обычного AVL-деревьев
+void testPersistentAVLTree() {
+    const int REPETITIONS = 10;
+    const int OPERATIONS = 1000;
+
+    ofstream csv("persistent_avl_results.csv");
+    csv << "N,Mutable_Insert,Persistent_Insert,Mutable_Delete,Persistent_Delete,"
+           "Mutable_Search,Persistent_Search,Mutable_Copy,Persistent_Snapshot,Nodes_Per_Op\n";
+
+    for (int i = 10; i <= 18; ++i) {
+        const size_t N = 1 << i; // 2^i
+
+        vector<double> times[8];
+        vector<double> nodesPerOp;
+
+        cout << "Testing N = 2^" << i << " = " << N << "..." << endl;
+
+        for (int rep = 0; rep < REPETITIONS; ++rep) {
+            // 1. Генерация N случайных значений и операций
+            vector<int> elements(N);
+            for (auto& elem : elements) {
+                elem = rand() % (10 * N);
+            }
+            vector<int> insertKeys(OPERATIONS), queryKeys(OPERATIONS);
+            for (int j = 0; j < OPERATIONS; ++j) {
+                insertKeys[j] = rand() % (10 * N);
+                queryKeys[j] = rand() % 2 ? elements[rand() % N] : rand() % (10 * N);
+            }
+
+            // 2. Заполнение деревьев
+            AVLTree mutableTree;
+            PersistentAVLTree persistent;
+            for (int elem : elements) {
+                mutableTree.insert(elem);
+                persistent = persistent.insert(elem);
+            }
+
+            auto measure = [](auto action) {
+                auto start = high_resolution_clock::now();
+                action();
+                auto end = high_resolution_clock::now();
+                return duration_cast<microseconds>(end - start).count() / 1000.0;
+            };
+
+            // 3. Снимок перед изменениями: копия обычного дерева и O(1) снимок персистентного
+            times[6].push_back(measure([&]() {
+                AVLTree copy(mutableTree);
+            }));
+            PersistentAVLTree snapshot;
+            times[7].push_back(measure([&]() {
+                snapshot = persistent;
+            }));
+
+            // 4. 1000 операций вставки (старая версия остаётся в snapshot)
+            long long nodesBefore = PersistentNode::liveNodes.load();
+            times[0].push_back(measure([&]() {
+                for (int key : insertKeys) mutableTree.insert(key);
+            }));
+            times[1].push_back(measure([&]() {
+                for (int key : insertKeys) persistent = persistent.insert(key);
+            }));
+            nodesPerOp.push_back(static_cast<double>(PersistentNode::liveNodes.load() - nodesBefore) / OPERATIONS);
+
+            // 5. 1000 операций удаления
+            times[2].push_back(measure([&]() {
+                for (int key : queryKeys) mutableTree.remove(key);
+            }));
+            times[3].push_back(measure([&]() {
+                for (int key : queryKeys) persistent = persistent.remove(key);
+            }));
+
+            // 6. 1000 операций поиска
+            volatile size_t hits = 0;
+            times[4].push_back(measure([&]() {
+                size_t found = 0;
+                for (int key : queryKeys) found += mutableTree.contains(key);
+                hits = found;
+            }));
+            times[5].push_back(measure([&]() {
+                size_t found = 0;
+                for (int key : queryKeys) found += persistent.contains(key);
+                hits = found;
+            }));
+
+            // Снимок не должен измениться после операций над новыми версиями
+            if (!snapshot.isValid() || !persistent.isValid() || !snapshot.contains(elements[0])) {
+                cout << "  Persistent tree check failed!" << endl;
+            }
+        }
+
+        double avg[8];
+        for (int k = 0; k < 8; ++k) {
+            avg[k] = accumulate(times[k].begin(), times[k].end(), 0.0) / times[k].size();
+        }
+        double avgNodes = accumulate(nodesPerOp.begin(), nodesPerOp.end(), 0.0) / nodesPerOp.size();
+
+        cout << "Results for N = " << N << ":" << endl;
+        cout << "  Insert time for " << OPERATIONS << " ops: mutable " << avg[0] << " ms, persistent " << avg[1] << " ms" << endl;
+        cout << "  Delete time for " << OPERATIONS << " ops: mutable " << avg[2] << " ms, persistent " << avg[3] << " ms" << endl;
+        cout << "  Search time for " << OPERATIONS << " ops: mutable " << avg[4] << " ms, persistent " << avg[5] << " ms" << endl;
+        cout << "  Snapshot: mutable copy " << avg[6] << " ms, persistent " << avg[7] << " ms" << endl;
+        cout << "  Retained nodes per insert with a live snapshot: " << avgNodes << " (log2 N = " << log2(N) << ")" << endl;
+        cout << endl;
+
+        csv << N;
+        for (double value : avg) csv << "," << value;
+        csv << "," << avgNodes << "\n";
+    }
+
+    cout << "Results saved to persistent_avl_results.csv" << endl;
+}
+
+int main() {
+    srand(time(nullptr)); // Инициализация генератора случайных чисел
+    testPersistentAVLTree();
+    return 0;
+}
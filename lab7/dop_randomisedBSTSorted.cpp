@@ -7,6 +7,14 @@
 #include <climits>
 #include <fstream>
 #include <map>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <exception>
+#include <string>
+#include <ctime>
+#include <stdexcept>
+#include "benchRunner.h"
 
 using namespace std;
 using namespace std::chrono;
@@ -27,6 +35,18 @@ private:
     Node* root;
     mt19937 gen;
     
+    // Кэш правого хребта для добавления в конец. Рандомизированное дерево
+    // распределено так же, как декартово с независимыми приоритетами, поэтому
+    // узлам хребта приписываются приоритеты, согласованные с формой дерева,
+    // и новый ключ встаёт на своё место снизу, как при построении стеком.
+    // Размеры узлов хребта обновляются лениво: к size узла spine[i]
+    // ещё не прибавлено pendingAppends - spineBase[i] добавленных под ним ключей
+    vector<Node*> spine;
+    vector<double> spinePriority;
+    vector<long long> spineBase;
+    long long pendingAppends;
+    bool spineValid;
+    
     // Обновление размера поддерева
     void updateSize(Node* node) {
         if (node) {
@@ -119,17 +139,35 @@ private:
         return 1 + max(maxDepth(node->left), maxDepth(node->right));
     }
     
-    // Сбор глубин всех веток
-    void collectBranchDepths(Node* node, int currentDepth, vector<int>& depths) const {
-        if (!node) return;
+    // Восстановление кэша хребта. Приоритет корня поддерева размера s при
+    // приоритете родителя P распределён как максимум s равномерных величин
+    // на [0, P), то есть P * U^(1/s)
+    void ensureSpine() {
+        if (spineValid) return;
         
-        if (!node->left && !node->right) {
-            depths.push_back(currentDepth + 1);
-            return;
+        uniform_real_distribution<> uniform(0.0, 1.0);
+        double priority = 1.0;
+        for (Node* node = root; node; node = node->right) {
+            priority *= pow(uniform(gen), 1.0 / node->size);
+            spine.push_back(node);
+            spinePriority.push_back(priority);
+            spineBase.push_back(0);
         }
-        
-        collectBranchDepths(node->left, currentDepth + 1, depths);
-        collectBranchDepths(node->right, currentDepth + 1, depths);
+        pendingAppends = 0;
+        spineValid = true;
+    }
+    
+    // Перенос отложенных размеров в узлы хребта и сброс кэша.
+    // Вызывается перед любой операцией, которая читает размеры
+    void flushSpine() {
+        for (size_t i = 0; i < spine.size(); ++i) {
+            spine[i]->size += pendingAppends - spineBase[i];
+        }
+        spine.clear();
+        spinePriority.clear();
+        spineBase.clear();
+        pendingAppends = 0;
+        spineValid = false;
     }
     
     // Оптимальное построение дерева из отсортированного массива
@@ -148,42 +186,64 @@ private:
     }
     
 public:
-    SortedRandomizedBST() : root(nullptr), gen(random_device{}()) {}
+    SortedRandomizedBST() : root(nullptr), gen(random_device{}()), pendingAppends(0), spineValid(false) {}
+    explicit SortedRandomizedBST(unsigned seed) : root(nullptr), gen(seed), pendingAppends(0), spineValid(false) {}
     
-    // Вставка элемента (всегда в конец для отсортированных данных)
+    // Вставка элемента в конец (ключ больше всех существующих).
+    // Узлы хребта с меньшим приоритетом уходят в левое поддерево нового узла;
+    // каждый узел снимается с хребта не больше одного раза, поэтому
+    // вставка амортизированно O(1), а размеры выше досчитываются лениво
     void insertSorted(int key) {
-        if (!root) {
-            root = new Node(key);
-            return;
+        ensureSpine();
+        if (!spine.empty() && key <= spine.back()->key) {
+            throw invalid_argument("SortedRandomizedBST: appended keys must be strictly greater than the current maximum");
         }
         
-        // Для отсортированных данных всегда вставляем в правое поддерево
-        Node* node = root;
-        Node* parent = nullptr;
+        double priority = uniform_real_distribution<>(0.0, 1.0)(gen);
+        Node* node = new Node(key);
+        Node* lastPopped = nullptr;
         
-        while (node) {
-            parent = node;
-            node = node->right;
+        while (!spine.empty() && spinePriority.back() < priority) {
+            lastPopped = spine.back();
+            lastPopped->size += pendingAppends - spineBase.back();
+            spine.pop_back();
+            spinePriority.pop_back();
+            spineBase.pop_back();
         }
         
-        parent->right = new Node(key);
+        node->left = lastPopped;
+        node->size = 1 + getSize(lastPopped);
+        if (spine.empty()) root = node; else spine.back()->right = node;
         
-        // Обновляем размеры на пути к корню
-        node = root;
-        while (node) {
-            updateSize(node);
-            node = node->right;
-        }
+        // Новый ключ учитывается всеми оставшимися узлами хребта
+        ++pendingAppends;
+        spine.push_back(node);
+        spinePriority.push_back(priority);
+        spineBase.push_back(pendingAppends);
+    }
+    
+    // Пакетное добавление возрастающей серии ключей: из серии строится
+    // случайное поддерево, которое сливается с деревом через merge
+    // (спуск по правому краю дерева и левому краю серии) - O(k + log n)
+    void appendRange(const vector<int>& keys) {
+        if (keys.empty()) return;
         
-        // С вероятностью 1/(n+1) делаем вставку в корень
-        if (uniform_int_distribution<>(0, getSize(root))(gen) == 0) {
-            root = insertRoot(root, key);
+        ensureSpine();
+        for (size_t i = 0; i < keys.size(); ++i) {
+            if ((i == 0 && !spine.empty() && keys[i] <= spine.back()->key) ||
+                (i > 0 && keys[i] <= keys[i - 1])) {
+                throw invalid_argument("SortedRandomizedBST: appended keys must be strictly greater than the current maximum");
+            }
         }
+        
+        flushSpine();
+        root = merge(root, buildBalancedFromSortedArray(keys, 0, keys.size() - 1));
     }
     
     // Построение дерева из отсортированного массива
     void buildFromSortedArray(const vector<int>& sortedArray) {
         clear();
+        flushSpine();
         if (!sortedArray.empty()) {
             root = buildBalancedFromSortedArray(sortedArray, 0, sortedArray.size() - 1);
         }
@@ -191,6 +251,7 @@ public:
     
     // Удаление элемента
     void remove(int key) {
+        flushSpine();
         root = remove(root, key);
     }
     
@@ -204,11 +265,28 @@ public:
         return maxDepth(root);
     }
     
-    // Получение глубин всех веток
-    vector<int> getAllBranchDepths() const {
-        vector<int> depths;
-        collectBranchDepths(root, 0, depths);
-        return depths;
+    // Добавление глубин всех веток в профиль. Обход без рекурсии: в стеке
+    // только отложенные правые поддеревья, по одному на уровень - O(высоты)
+    void profileDepths(DepthProfile& profile) const {
+        vector<pair<const Node*, int>> pending;
+        const Node* node = root;
+        int depth = 1;
+        while (node) {
+            bool hasLeft = node->left;
+            bool hasRight = node->right;
+            if (hasLeft || hasRight) {
+                if (hasLeft && hasRight) pending.push_back({node->right, depth + 1});
+                node = hasLeft ? node->left : node->right;
+                ++depth;
+                continue;
+            }
+    
+            profile.add(depth);
+            if (pending.empty()) break;
+            node = pending.back().first;
+            depth = pending.back().second;
+            pending.pop_back();
+        }
     }
     
     // Очистка дерева
@@ -220,24 +298,26 @@ public:
 };
 
 // Функция для тестирования с отсортированными данными
-void testSortedRandomizedBST() {
+void testSortedRandomizedBST(const RunOptions& options) {
     const int REPETITIONS = 50;
     const int OPERATIONS = 1000;
     
     for (int i = 10; i <= 18; ++i) {
         const size_t N = 1 << i; // 2^i
         
-        vector<double> maxDepths;
-        vector<double> buildTimes;
-        vector<double> insertTimes;
-        vector<double> deleteTimes;
-        vector<double> searchTimes;
-        vector<int> allBranchDepths;
+        vector<double> maxDepths(REPETITIONS);
+        vector<double> buildTimes(REPETITIONS);
+        vector<double> insertTimes(REPETITIONS);
+        vector<double> appendRangeTimes(REPETITIONS);
+        vector<double> deleteTimes(REPETITIONS);
+        vector<double> searchTimes(REPETITIONS);
+        DepthProfile branchProfile;
+        vector<DepthProfile> repProfiles(REPETITIONS);
         
         // cout << "Testing Sorted Randomized BST with N = 2^" << i << " = " << N << "..." << endl;
         
-        for (int rep = 0; rep < REPETITIONS; ++rep) {
-            SortedRandomizedBST tree;
+        runRepetitions(REPETITIONS, i, options, [&](int rep, mt19937& rng) {
+            SortedRandomizedBST tree(rng());
             
             // 1. Генерация отсортированных значений
             vector<int> elements(N);
@@ -249,10 +329,10 @@ void testSortedRandomizedBST() {
             auto start = high_resolution_clock::now();
             tree.buildFromSortedArray(elements);
             auto end = high_resolution_clock::now();
-            buildTimes.push_back(duration_cast<microseconds>(end - start).count() / 1000.0);
+            buildTimes[rep] = duration_cast<microseconds>(end - start).count() / 1000.0;
             
             // 3. Замер максимальной глубины
-            maxDepths.push_back(tree.getMaxDepth());
+            maxDepths[rep] = tree.getMaxDepth();
             
             // 4. 1000 операций вставки в конец и замер времени
             start = high_resolution_clock::now();
@@ -260,58 +340,74 @@ void testSortedRandomizedBST() {
                 tree.insertSorted(N + j); // Вставляем элементы больше всех существующих
             }
             end = high_resolution_clock::now();
-            insertTimes.push_back(duration_cast<microseconds>(end - start).count() / 1000.0);
+            insertTimes[rep] = duration_cast<microseconds>(end - start).count() / 1000.0;
+            
+            // 4.1. Пакетное добавление серии из 1000 следующих ключей
+            vector<int> run(OPERATIONS);
+            for (int j = 0; j < OPERATIONS; ++j) {
+                run[j] = N + OPERATIONS + j;
+            }
+            start = high_resolution_clock::now();
+            tree.appendRange(run);
+            end = high_resolution_clock::now();
+            appendRangeTimes[rep] = duration_cast<microseconds>(end - start).count() / 1000.0;
             
             // 5. 1000 операций удаления и замер времени
             start = high_resolution_clock::now();
             for (int j = 0; j < OPERATIONS; ++j) {
                 int elem = elements.empty() ? N + j : 
-                          elements[rand() % elements.size()];
+                          elements[rng() % elements.size()];
                 tree.remove(elem);
                 if (!elements.empty()) {
                     elements.erase(remove(elements.begin(), elements.end(), elem), elements.end());
                 }
             }
             end = high_resolution_clock::now();
-            deleteTimes.push_back(duration_cast<microseconds>(end - start).count() / 1000.0);
+            deleteTimes[rep] = duration_cast<microseconds>(end - start).count() / 1000.0;
             
             // 6. 1000 операций поиска и замер времени
             start = high_resolution_clock::now();
             for (int j = 0; j < OPERATIONS; ++j) {
                 int elem = elements.empty() ? N + j : 
-                          elements[rand() % elements.size()];
+                          elements[rng() % elements.size()];
                 tree.contains(elem);
             }
             end = high_resolution_clock::now();
-            searchTimes.push_back(duration_cast<microseconds>(end - start).count() / 1000.0);
+            searchTimes[rep] = duration_cast<microseconds>(end - start).count() / 1000.0;
             
-            // 7. Сбор глубин всех веток
-            vector<int> depths = tree.getAllBranchDepths();
-            allBranchDepths.insert(allBranchDepths.end(), depths.begin(), depths.end());
+            // 7. Профиль глубин всех веток
+            tree.profileDepths(repProfiles[rep]);
+        });
+        
+        // Профили повторений сливаются по порядку номеров
+        for (const DepthProfile& profile : repProfiles) {
+            branchProfile.merge(profile);
         }
         
         // Вычисление статистики
         double avgMaxDepth = accumulate(maxDepths.begin(), maxDepths.end(), 0.0) / maxDepths.size();
         double avgBuildTime = accumulate(buildTimes.begin(), buildTimes.end(), 0.0) / buildTimes.size();
         double avgInsertTime = accumulate(insertTimes.begin(), insertTimes.end(), 0.0) / insertTimes.size();
+        double avgAppendRangeTime = accumulate(appendRangeTimes.begin(), appendRangeTimes.end(), 0.0) / appendRangeTimes.size();
         double avgDeleteTime = accumulate(deleteTimes.begin(), deleteTimes.end(), 0.0) / deleteTimes.size();
         double avgSearchTime = accumulate(searchTimes.begin(), searchTimes.end(), 0.0) / searchTimes.size();
         
-        double avgBranchDepth = accumulate(allBranchDepths.begin(), allBranchDepths.end(), 0.0) / allBranchDepths.size();
-        int minBranchDepth = *min_element(allBranchDepths.begin(), allBranchDepths.end());
-        int maxBranchDepth = *max_element(allBranchDepths.begin(), allBranchDepths.end());
+        double avgBranchDepth = branchProfile.mean();
+        int minBranchDepth = branchProfile.minDepth();
+        int maxBranchDepth = branchProfile.maxDepth();
         
         // Вывод результатов
         /*cout << "Results for sorted N = " << N << ":" << endl;
         cout << "  Average build time: " << avgBuildTime << " ms" << endl;
         cout << "  Average max depth: " << avgMaxDepth << " (expected ~" << log2(N) << ")" << endl;
         cout << "  Average insert time for " << OPERATIONS << " ops: " << avgInsertTime << " ms" << endl;
+        cout << "  Average appendRange time for " << OPERATIONS << " keys: " << avgAppendRangeTime << " ms" << endl;
         cout << "  Average delete time for " << OPERATIONS << " ops: " << avgDeleteTime << " ms" << endl;
         cout << "  Average search time for " << OPERATIONS << " ops: " << avgSearchTime << " ms" << endl;
         cout << "  Branch depths - avg: " << avgBranchDepth << ", min: " << minBranchDepth 
-             << ", max: " << maxBranchDepth << endl;
+             << ", max: " << maxBranchDepth << ", stddev: " << branchProfile.stddev() << endl;
         cout << endl;*/
-        cout << N << "," << avgInsertTime << "," << avgDeleteTime << "," << avgSearchTime << "," << avgMaxDepth << endl;
+        cout << N << "," << avgInsertTime << "," << avgDeleteTime << "," << avgSearchTime << "," << avgMaxDepth << "," << avgAppendRangeTime << endl;
         
 
         if (i == 18) {
@@ -323,33 +419,29 @@ void testSortedRandomizedBST() {
             }
             
             // 2. Улучшенная гистограмма высот веток
-            vector<int> branchDepths = allBranchDepths;
-            if (!branchDepths.empty()) {
+            if (branchProfile.leaves) {
                 // Удаляем выбросы - только 99% данных
-                sort(branchDepths.begin(), branchDepths.end());
-                int cutoff = branchDepths[branchDepths.size() * 0.99];
-                branchDepths.erase(remove_if(branchDepths.begin(), branchDepths.end(), 
-                                        [cutoff](int x) { return x > cutoff; }), 
-                                branchDepths.end());
+                int cutoff = branchProfile.percentile(0.99);
                 
                 // Автоподбор бинов с учетом распределения
-                int min_depth = *min_element(branchDepths.begin(), branchDepths.end());
-                int max_depth = *max_element(branchDepths.begin(), branchDepths.end());
+                int min_depth = branchProfile.minDepth();
+                int max_depth = cutoff;
                 int range = max_depth - min_depth;
                 int num_bins = 20; // Фиксированное количество бинов
                 int bin_size = max(1, range / num_bins);
                 
-                map<int, int> branchDepthHist;
-                for (int depth : branchDepths) {
+                map<int, long long> branchDepthHist;
+                for (int depth = min_depth; depth <= max_depth; ++depth) {
+                    if (!branchProfile.counts[depth]) continue;
                     int bin = (depth - min_depth) / bin_size * bin_size + min_depth;
-                    branchDepthHist[bin]++;
+                    branchDepthHist[bin] += branchProfile.counts[depth];
                 }
                 
                 ofstream branchDepthFile("sorted_rbst_branch_depths.csv");
                 branchDepthFile << "Depth,Count\n"; // Изменили заголовок
                 
                 // Нормализуем диапазоны и сортируем по глубине
-                vector<pair<int, int>> sorted_bins(branchDepthHist.begin(), branchDepthHist.end());
+                vector<pair<int, long long>> sorted_bins(branchDepthHist.begin(), branchDepthHist.end());
                 sort(sorted_bins.begin(), sorted_bins.end());
                 
                 for (const auto& [depth, count] : sorted_bins) {
@@ -362,8 +454,13 @@ void testSortedRandomizedBST() {
     }
 }
 
-int main() {
-    srand(time(nullptr)); // Инициализация генератора случайных чисел
-    testSortedRandomizedBST();
+int main(int argc, char** argv) {
+    try {
+        RunOptions options = parseOptions(argc, argv);
+        testSortedRandomizedBST(options);
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
     return 0;
 }
@@ -0,0 +1,700 @@
+/*
+13) Дерево козла отпущения и дерево, сбалансированное по весу: вместо
+    поворотов на каждой вставке - редкие перестройки поддерева в идеально
+    сбалансированное (buildBalancedFromSortedArray поверх уже существующих
+    узлов). У дерева козла отпущения в узле нет ничего, кроме ключа и ссылок.
+ */
+
+// реализация деревьев с ленивыми перестройками
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <climits>
+#include <fstream>
+#include <map>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <exception>
+#include <ctime>
+#include <utility>
+#include <stdexcept>
+#include "benchRunner.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// Узел дерева козла отпущения: никаких данных о балансе, только ключ и ссылки
+struct ScapegoatNode {
+    int key;
+    ScapegoatNode* left;
+    ScapegoatNode* right;
+
+    ScapegoatNode(int k) : key(k), left(nullptr), right(nullptr) {}
+};
+
+// Дерево козла отпущения с alpha = 2/3. Вставка спускается как в обычном
+// BST; если новый узел оказался глубже log_{3/2}(maxSize), на пути вверх
+// находится самый нижний несбалансированный предок ("козёл отпущения"),
+// и его поддерево перестраивается в идеально сбалансированное.
+// Удаление ленивое: дерево целиком перестраивается, когда в нём остаётся
+// меньше 2/3 от максимального с прошлой перестройки числа ключей
+class ScapegoatTree {
+private:
+    ScapegoatNode* root;
+    int count;
+    int maxCount;
+    long long rebuilt; // Сколько узлов прошло через перестройки
+    vector<ScapegoatNode*> path; // Путь последней вставки; память переиспользуется
+
+    // Допустимая глубина: floor(log_{3/2} n)
+    static int depthLimit(int n) {
+        return n > 1 ? static_cast<int>(floor(log(static_cast<double>(n)) / log(1.5))) : 0;
+    }
+
+    // Размер поддерева без хранимых размеров - считается обходом.
+    // Вызывается только при поиске козла отпущения, его стоимость
+    // покрывается последующей перестройкой
+    static int subtreeSize(ScapegoatNode* node) {
+        int size = 0;
+        vector<ScapegoatNode*> pending;
+        while (node) {
+            ++size;
+            if (node->left && node->right) pending.push_back(node->right);
+            if (node->left || node->right) {
+                node = node->left ? node->left : node->right;
+            } else if (!pending.empty()) {
+                node = pending.back();
+                pending.pop_back();
+            } else {
+                node = nullptr;
+            }
+        }
+        return size;
+    }
+
+    // Узлы поддерева в порядке возрастания ключей (обход без рекурсии)
+    static void flatten(ScapegoatNode* node, vector<ScapegoatNode*>& nodes) {
+        vector<ScapegoatNode*> stack;
+        while (node || !stack.empty()) {
+            while (node) {
+                stack.push_back(node);
+                node = node->left;
+            }
+            node = stack.back();
+            stack.pop_back();
+            nodes.push_back(node);
+            node = node->right;
+        }
+    }
+
+    // Построение сбалансированного дерева из отсортированного массива
+    ScapegoatNode* buildBalancedFromSortedArray(const vector<int>& sortedArray, int start, int end) {
+        if (start > end) return nullptr;
+
+        int mid = start + (end - start) / 2;
+        ScapegoatNode* node = new ScapegoatNode(sortedArray[mid]);
+
+        node->left = buildBalancedFromSortedArray(sortedArray, start, mid - 1);
+        node->right = buildBalancedFromSortedArray(sortedArray, mid + 1, end);
+
+        return node;
+    }
+
+    // То же построение, но из уже существующих узлов: перестройка
+    // не выделяет память, а только переставляет ссылки
+    ScapegoatNode* buildBalancedFromSortedArray(const vector<ScapegoatNode*>& nodes, int start, int end) {
+        if (start > end) return nullptr;
+
+        int mid = start + (end - start) / 2;
+        ScapegoatNode* node = nodes[mid];
+
+        node->left = buildBalancedFromSortedArray(nodes, start, mid - 1);
+        node->right = buildBalancedFromSortedArray(nodes, mid + 1, end);
+
+        return node;
+    }
+
+    ScapegoatNode* rebuild(ScapegoatNode* node) {
+        vector<ScapegoatNode*> nodes;
+        flatten(node, nodes);
+        rebuilt += nodes.size();
+        return buildBalancedFromSortedArray(nodes, 0, static_cast<int>(nodes.size()) - 1);
+    }
+
+    static int maxDepth(ScapegoatNode* node) {
+        if (!node) return 0;
+        return 1 + max(maxDepth(node->left), maxDepth(node->right));
+    }
+
+    static bool checkOrder(ScapegoatNode* node, long long lo, long long hi) {
+        if (!node) return true;
+        if (node->key <= lo || node->key >= hi) return false;
+        return checkOrder(node->left, lo, node->key) && checkOrder(node->right, node->key, hi);
+    }
+
+public:
+    ScapegoatTree() : root(nullptr), count(0), maxCount(0), rebuilt(0) {}
+
+    ~ScapegoatTree() {
+        clear();
+    }
+
+    ScapegoatTree(const ScapegoatTree&) = delete;
+    ScapegoatTree& operator=(const ScapegoatTree&) = delete;
+
+    void insert(int key) {
+        path.clear();
+        ScapegoatNode** link = &root;
+        while (*link) {
+            ScapegoatNode* node = *link;
+            if (key == node->key) return; // Дубликаты не допускаются
+            path.push_back(node);
+            link = key < node->key ? &node->left : &node->right;
+        }
+
+        ScapegoatNode* created = new ScapegoatNode(key);
+        *link = created;
+        ++count;
+        maxCount = max(maxCount, count);
+
+        if (static_cast<int>(path.size()) <= depthLimit(maxCount)) return;
+
+        // Подъём к корню: первый предок, у которого ребёнок на пути
+        // весит больше 2/3 всего поддерева, и есть козёл отпущения
+        ScapegoatNode* child = created;
+        int childSize = 1;
+        for (int i = static_cast<int>(path.size()) - 1; i >= 0; --i) {
+            ScapegoatNode* parent = path[i];
+            ScapegoatNode* sibling = parent->left == child ? parent->right : parent->left;
+            int parentSize = childSize + 1 + subtreeSize(sibling);
+
+            if (3 * childSize > 2 * parentSize) {
+                ScapegoatNode* rebuiltRoot = rebuild(parent);
+                if (i == 0) {
+                    root = rebuiltRoot;
+                } else if (path[i - 1]->left == parent) {
+                    path[i - 1]->left = rebuiltRoot;
+                } else {
+                    path[i - 1]->right = rebuiltRoot;
+                }
+                return;
+            }
+
+            child = parent;
+            childSize = parentSize;
+        }
+    }
+
+    void remove(int key) {
+        ScapegoatNode** link = &root;
+        while (*link && (*link)->key != key) {
+            link = key < (*link)->key ? &(*link)->left : &(*link)->right;
+        }
+
+        ScapegoatNode* node = *link;
+        if (!node) return;
+
+        if (node->left && node->right) {
+            // Ключ заменяется минимумом правого поддерева, удаляется его узел
+            ScapegoatNode** successorLink = &node->right;
+            while ((*successorLink)->left) successorLink = &(*successorLink)->left;
+            node->key = (*successorLink)->key;
+            link = successorLink;
+            node = *successorLink;
+        }
+
+        *link = node->left ? node->left : node->right;
+        delete node;
+        --count;
+
+        // Ленивая глобальная перестройка после множества удалений
+        if (3 * count < 2 * maxCount) {
+            root = rebuild(root);
+            maxCount = count;
+        }
+    }
+
+    bool contains(int key) const {
+        const ScapegoatNode* node = root;
+        while (node) {
+            if (key == node->key) return true;
+            node = key < node->key ? node->left : node->right;
+        }
+        return false;
+    }
+
+    // Построение из отсортированного массива без повторов
+    void buildFromSortedArray(const vector<int>& sortedArray) {
+        clear();
+        root = buildBalancedFromSortedArray(sortedArray, 0, static_cast<int>(sortedArray.size()) - 1);
+        count = maxCount = static_cast<int>(sortedArray.size());
+    }
+
+    void clear() {
+        vector<ScapegoatNode*> nodes;
+        flatten(root, nodes);
+        for (ScapegoatNode* node : nodes) {
+            delete node;
+        }
+        root = nullptr;
+        count = maxCount = 0;
+    }
+
+    int size() const {
+        return count;
+    }
+
+    long long rebuiltNodes() const {
+        return rebuilt;
+    }
+
+    int getMaxDepth() const {
+        return maxDepth(root);
+    }
+
+    // Добавление глубин всех веток в профиль. Обход без рекурсии: в стеке
+    // только отложенные правые поддеревья, по одному на уровень - O(высоты)
+    void profileDepths(DepthProfile& profile) const {
+        vector<pair<const ScapegoatNode*, int>> pending;
+        const ScapegoatNode* node = root;
+        int depth = 1;
+        while (node) {
+            bool hasLeft = node->left;
+            bool hasRight = node->right;
+            if (hasLeft || hasRight) {
+                if (hasLeft && hasRight) pending.push_back({node->right, depth + 1});
+                node = hasLeft ? node->left : node->right;
+                ++depth;
+                continue;
+            }
+
+            profile.add(depth);
+            if (pending.empty()) break;
+            node = pending.back().first;
+            depth = pending.back().second;
+            pending.pop_back();
+        }
+    }
+
+    // Порядок ключей, число узлов и граница высоты log_{3/2}(maxSize) + 1
+    bool isValid() const {
+        return checkOrder(root, LLONG_MIN, LLONG_MAX) && subtreeSize(root) == count &&
+               getMaxDepth() <= depthLimit(maxCount) + 1;
+    }
+};
+
+// Узел дерева, сбалансированного по весу: хранится размер поддерева
+struct WeightNode {
+    int key;
+    WeightNode* left;
+    WeightNode* right;
+    int size;
+
+    WeightNode(int k) : key(k), left(nullptr), right(nullptr), size(1) {}
+};
+
+// Дерево, сбалансированное по весу (BB[alpha], alpha = 0.7), с частичной
+// перестройкой вместо поворотов: после вставки или удаления на пути от
+// корня ищется самый верхний узел, у которого ребёнок тяжелее 70% его
+// поддерева, и это поддерево перестраивается в идеально сбалансированное.
+// В отличие от козла отпущения, размеры известны сразу, поэтому
+// нарушение ловится и при удалении, без глобальной перестройки
+class WeightBalancedTree {
+private:
+    static const int ALPHA_NUMERATOR = 7;
+    static const int ALPHA_DENOMINATOR = 10;
+
+    WeightNode* root;
+    long long rebuilt;
+    vector<WeightNode*> path; // Путь последней операции; память переиспользуется
+
+    static int getSize(WeightNode* node) {
+        return node ? node->size : 0;
+    }
+
+    static bool isBalanced(WeightNode* node) {
+        int limit = ALPHA_NUMERATOR * node->size;
+        return ALPHA_DENOMINATOR * getSize(node->left) <= limit &&
+               ALPHA_DENOMINATOR * getSize(node->right) <= limit;
+    }
+
+    static void flatten(WeightNode* node, vector<WeightNode*>& nodes) {
+        vector<WeightNode*> stack;
+        while (node || !stack.empty()) {
+            while (node) {
+                stack.push_back(node);
+                node = node->left;
+            }
+            node = stack.back();
+            stack.pop_back();
+            nodes.push_back(node);
+            node = node->right;
+        }
+    }
+
+    // Построение сбалансированного дерева из отсортированного массива
+    WeightNode* buildBalancedFromSortedArray(const vector<int>& sortedArray, int start, int end) {
+        if (start > end) return nullptr;
+
+        int mid = start + (end - start) / 2;
+        WeightNode* node = new WeightNode(sortedArray[mid]);
+
+        node->left = buildBalancedFromSortedArray(sortedArray, start, mid - 1);
+        node->right = buildBalancedFromSortedArray(sortedArray, mid + 1, end);
+
+        node->size = end - start + 1;
+        return node;
+    }
+
+    // То же построение из существующих узлов
+    WeightNode* buildBalancedFromSortedArray(const vector<WeightNode*>& nodes, int start, int end) {
+        if (start > end) return nullptr;
+
+        int mid = start + (end - start) / 2;
+        WeightNode* node = nodes[mid];
+
+        node->left = buildBalancedFromSortedArray(nodes, start, mid - 1);
+        node->right = buildBalancedFromSortedArray(nodes, mid + 1, end);
+
+        node->size = end - start + 1;
+        return node;
+    }
+
+    WeightNode* rebuild(WeightNode* node) {
+        vector<WeightNode*> nodes;
+        nodes.reserve(node->size);
+        flatten(node, nodes);
+        rebuilt += nodes.size();
+        return buildBalancedFromSortedArray(nodes, 0, static_cast<int>(nodes.size()) - 1);
+    }
+
+    // Перестройка самого верхнего несбалансированного узла на пути.
+    // path[0] - корень, дальше каждый узел - ребёнок предыдущего
+    void rebalancePath() {
+        for (size_t i = 0; i < path.size(); ++i) {
+            if (isBalanced(path[i])) continue;
+
+            WeightNode* rebuiltRoot = rebuild(path[i]);
+            if (i == 0) {
+                root = rebuiltRoot;
+            } else if (path[i - 1]->left == path[i]) {
+                path[i - 1]->left = rebuiltRoot;
+            } else {
+                path[i - 1]->right = rebuiltRoot;
+            }
+            return;
+        }
+    }
+
+    static int maxDepth(WeightNode* node) {
+        if (!node) return 0;
+        return 1 + max(maxDepth(node->left), maxDepth(node->right));
+    }
+
+    static bool checkNode(WeightNode* node, long long lo, long long hi) {
+        if (!node) return true;
+        if (node->key <= lo || node->key >= hi) return false;
+        if (node->size != 1 + getSize(node->left) + getSize(node->right)) return false;
+        if (!isBalanced(node)) return false;
+        return checkNode(node->left, lo, node->key) && checkNode(node->right, node->key, hi);
+    }
+
+public:
+    WeightBalancedTree() : root(nullptr), rebuilt(0) {}
+
+    ~WeightBalancedTree() {
+        clear();
+    }
+
+    WeightBalancedTree(const WeightBalancedTree&) = delete;
+    WeightBalancedTree& operator=(const WeightBalancedTree&) = delete;
+
+    void insert(int key) {
+        if (contains(key)) return; // Дубликаты не допускаются
+
+        path.clear();
+        WeightNode** link = &root;
+        while (*link) {
+            WeightNode* node = *link;
+            ++node->size;
+            path.push_back(node);
+            link = key < node->key ? &node->left : &node->right;
+        }
+        *link = new WeightNode(key);
+
+        rebalancePath();
+    }
+
+    void remove(int key) {
+        if (!contains(key)) return;
+
+        path.clear();
+        WeightNode** link = &root;
+        while ((*link)->key != key) {
+            WeightNode* node = *link;
+            --node->size;
+            path.push_back(node);
+            link = key < node->key ? &node->left : &node->right;
+        }
+
+        WeightNode* node = *link;
+        if (node->left && node->right) {
+            // Ключ заменяется минимумом правого поддерева, удаляется его узел
+            --node->size;
+            path.push_back(node);
+            WeightNode** successorLink = &node->right;
+            while ((*successorLink)->left) {
+                --(*successorLink)->size;
+                path.push_back(*successorLink);
+                successorLink = &(*successorLink)->left;
+            }
+            node->key = (*successorLink)->key;
+            link = successorLink;
+            node = *successorLink;
+        }
+
+        *link = node->left ? node->left : node->right;
+        delete node;
+
+        rebalancePath();
+    }
+
+    bool contains(int key) const {
+        const WeightNode* node = root;
+        while (node) {
+            if (key == node->key) return true;
+            node = key < node->key ? node->left : node->right;
+        }
+        return false;
+    }
+
+    // Построение из отсортированного массива без повторов
+    void buildFromSortedArray(const vector<int>& sortedArray) {
+        clear();
+        root = buildBalancedFromSortedArray(sortedArray, 0, static_cast<int>(sortedArray.size()) - 1);
+    }
+
+    void clear() {
+        vector<WeightNode*> nodes;
+        flatten(root, nodes);
+        for (WeightNode* node : nodes) {
+            delete node;
+        }
+        root = nullptr;
+    }
+
+    int size() const {
+        return getSize(root);
+    }
+
+    long long rebuiltNodes() const {
+        return rebuilt;
+    }
+
+    int getMaxDepth() const {
+        return maxDepth(root);
+    }
+
+    // Добавление глубин всех веток в профиль. Обход без рекурсии: в стеке
+    // только отложенные правые поддеревья, по одному на уровень - O(высоты)
+    void profileDepths(DepthProfile& profile) const {
+        vector<pair<const WeightNode*, int>> pending;
+        const WeightNode* node = root;
+        int depth = 1;
+        while (node) {
+            bool hasLeft = node->left;
+            bool hasRight = node->right;
+            if (hasLeft || hasRight) {
+                if (hasLeft && hasRight) pending.push_back({node->right, depth + 1});
+                node = hasLeft ? node->left : node->right;
+                ++depth;
+                continue;
+            }
+
+            profile.add(depth);
+            if (pending.empty()) break;
+            node = pending.back().first;
+            depth = pending.back().second;
+            pending.pop_back();
+        }
+    }
+
+    // Порядок ключей, размеры поддеревьев и баланс по весу в каждом узле
+    bool isValid() const {
+        return checkNode(root, LLONG_MIN, LLONG_MAX);
+    }
+};
+
+// Функция для тестирования дерева с ленивыми перестройками; prefix - начало
+// имён CSV-файлов с гистограммами
+template <typename Tree>
+void testRebuildingTree(const string& prefix, const RunOptions& options) {
+    const int REPETITIONS = 50;
+    const int OPERATIONS = 1000;
+
+    cout << "N,Insert,Delete,Search,MaxDepth,Append,Fill,Build,RebuiltNodesPerKey" << endl;
+
+    for (int i = 10; i <= 18; ++i) {
+        const size_t N = 1 << i; // 2^i
+
+        vector<double> maxDepths(REPETITIONS);
+        vector<double> fillTimes(REPETITIONS);
+        vector<double> buildTimes(REPETITIONS);
+        vector<double> insertTimes(REPETITIONS);
+        vector<double> appendTimes(REPETITIONS);
+        vector<double> deleteTimes(REPETITIONS);
+        vector<double> searchTimes(REPETITIONS);
+        vector<double> rebuiltPerKey(REPETITIONS);
+        DepthProfile branchProfile;
+        vector<DepthProfile> repProfiles(REPETITIONS);
+
+        runRepetitions(REPETITIONS, i, options, [&](int rep, mt19937& rng) {
+            Tree tree;
+
+            // 1. Генерация N случайных значений
+            vector<int> elements(N);
+            for (auto& elem : elements) {
+                elem = rng() % (10 * N);
+            }
+
+            // 2. Заполнение дерева
+            auto start = high_resolution_clock::now();
+            for (int elem : elements) {
+                tree.insert(elem);
+            }
+            auto end = high_resolution_clock::now();
+            fillTimes[rep] = duration_cast<microseconds>(end - start).count() / 1000.0;
+
+            // 2.1. Построение отдельного дерева из тех же ключей, заранее
+            // отсортированных и без повторов
+            vector<int> sortedElements = elements;
+            sort(sortedElements.begin(), sortedElements.end());
+            sortedElements.erase(unique(sortedElements.begin(), sortedElements.end()), sortedElements.end());
+            Tree built;
+            start = high_resolution_clock::now();
+            built.buildFromSortedArray(sortedElements);
+            end = high_resolution_clock::now();
+            buildTimes[rep] = duration_cast<microseconds>(end - start).count() / 1000.0;
+            if (built.size() != static_cast<int>(sortedElements.size()) || !built.isValid()) {
+                throw logic_error(prefix + " tree built from sorted array is invalid");
+            }
+
+            // 3. Замер максимальной глубины
+            maxDepths[rep] = tree.getMaxDepth();
+
+            // 4. 1000 операций вставки и замер времени
+            start = high_resolution_clock::now();
+            for (int j = 0; j < OPERATIONS; ++j) {
+                int elem = rng() % (10 * N);
+                tree.insert(elem);
+            }
+            end = high_resolution_clock::now();
+            insertTimes[rep] = duration_cast<microseconds>(end - start).count() / 1000.0;
+
+            // 4.1. 1000 вставок в конец (ключи больше всех существующих)
+            start = high_resolution_clock::now();
+            for (int j = 0; j < OPERATIONS; ++j) {
+                tree.insert(static_cast<int>(10 * N) + j);
+            }
+            end = high_resolution_clock::now();
+            appendTimes[rep] = duration_cast<microseconds>(end - start).count() / 1000.0;
+
+            // 5. 1000 операций удаления и замер времени
+            start = high_resolution_clock::now();
+            for (int j = 0; j < OPERATIONS; ++j) {
+                int elem = rng() % 2 ? elements[rng() % elements.size()] : rng() % (10 * N);
+                tree.remove(elem);
+            }
+            end = high_resolution_clock::now();
+            deleteTimes[rep] = duration_cast<microseconds>(end - start).count() / 1000.0;
+
+            // 6. 1000 операций поиска и замер времени; число найденных уходит
+            // в volatile, иначе компилятор выбросит поиск
+            volatile size_t hits = 0;
+            start = high_resolution_clock::now();
+            size_t found = 0;
+            for (int j = 0; j < OPERATIONS; ++j) {
+                int elem = rng() % 2 ? elements[rng() % elements.size()] : rng() % (10 * N);
+                found += tree.contains(elem);
+            }
+            hits = found;
+            (void)hits;
+            end = high_resolution_clock::now();
+            searchTimes[rep] = duration_cast<microseconds>(end - start).count() / 1000.0;
+
+            // 7. Профиль глубин всех веток и объём перестроек
+            tree.profileDepths(repProfiles[rep]);
+            rebuiltPerKey[rep] = static_cast<double>(tree.rebuiltNodes()) / (N + 2 * OPERATIONS);
+
+            if (!tree.isValid()) {
+                throw logic_error(prefix + " tree invariant violated");
+            }
+        });
+
+        // Профили повторений сливаются по порядку номеров
+        for (const DepthProfile& profile : repProfiles) {
+            branchProfile.merge(profile);
+        }
+
+        // Вычисление статистики
+        auto average = [](const vector<double>& values) {
+            return accumulate(values.begin(), values.end(), 0.0) / values.size();
+        };
+
+        cout << N << "," << average(insertTimes) << "," << average(deleteTimes) << "," << average(searchTimes) << ","
+             << average(maxDepths) << "," << average(appendTimes) << "," << average(fillTimes) << ","
+             << average(buildTimes) << "," << average(rebuiltPerKey) << endl;
+
+        if (i == 18) {
+            // 1. Все значения максимальных глубин
+            ofstream maxDepthFile(prefix + "_max_depths.csv");
+            maxDepthFile << "MaxDepth\n";
+            for (double depth : maxDepths) {
+                maxDepthFile << depth << "\n";
+            }
+
+            // 2. Гистограмма высот веток
+            map<int, long long> branchDepthHist;
+            int branchBinSize = 2; // Размер бина для группировки
+
+            for (int depth = branchProfile.minDepth(); depth <= branchProfile.maxDepth(); ++depth) {
+                if (!branchProfile.counts[depth]) continue;
+                int bin = depth / branchBinSize * branchBinSize;
+                branchDepthHist[bin] += branchProfile.counts[depth];
+            }
+
+            ofstream branchDepthFile(prefix + "_branch_depths.csv");
+            branchDepthFile << "Depth Range,Count\n";
+            for (const auto& [depth, count] : branchDepthHist) {
+                branchDepthFile << depth << "-" << (depth + branchBinSize - 1) << "," << count << "\n";
+            }
+
+            cout << "Branch depths - avg: " << branchProfile.mean() << ", min: " << branchProfile.minDepth()
+                 << ", max: " << branchProfile.maxDepth() << ", stddev: " << branchProfile.stddev() << endl;
+            cout << "Histogram data saved to " << prefix << "_max_depths.csv and "
+                 << prefix << "_branch_depths.csv" << endl;
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    try {
+        RunOptions options = parseOptions(argc, argv);
+
+        cout << "Scapegoat tree (alpha = 2/3)" << endl;
+        testRebuildingTree<ScapegoatTree>("scapegoat", options);
+
+        cout << endl << "Weight-balanced tree (alpha = 0.7)" << endl;
+        testRebuildingTree<WeightBalancedTree>("weight_balanced", options);
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,435 @@
+/*
+11) Декартово дерево (treap) - развитие рандомизированного BST: приоритет
+    выбирается один раз при создании узла, все операции выражаются через
+    split/merge. Удаление и извлечение диапазона ключей за O(log n),
+    параллельное построение из отсортированного массива.
+ */
+
+// реализация декартова дерева
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <climits>
+#include <fstream>
+#include <numeric>
+#include <thread>
+#include <utility>
+#include <stdexcept>
+
+using namespace std;
+using namespace std::chrono;
+
+// Узел декартова дерева
+struct TreapNode {
+    int key;
+    uint32_t priority; // Случайный приоритет, выбирается один раз
+    int size;          // Размер поддерева
+    TreapNode* left;
+    TreapNode* right;
+
+    TreapNode(int k, uint32_t p) : key(k), priority(p), size(1), left(nullptr), right(nullptr) {}
+};
+
+// Декартово дерево: BST по ключам и куча по приоритетам
+class Treap {
+private:
+    TreapNode* root;
+    mt19937 gen;
+
+    static const size_t PARALLEL_MIN_CHUNK = 1 << 14; // Меньшие части строятся в одном потоке
+
+    static int getSize(TreapNode* node) {
+        return node ? node->size : 0;
+    }
+
+    static void updateSize(TreapNode* node) {
+        node->size = 1 + getSize(node->left) + getSize(node->right);
+    }
+
+    // Разделение на ключи < key и >= key
+    static pair<TreapNode*, TreapNode*> split(TreapNode* node, int key) {
+        if (!node) return {nullptr, nullptr};
+        if (node->key < key) {
+            auto [left, right] = split(node->right, key);
+            node->right = left;
+            updateSize(node);
+            return {node, right};
+        }
+        auto [left, right] = split(node->left, key);
+        node->left = right;
+        updateSize(node);
+        return {left, node};
+    }
+
+    // Слияние деревьев, где все ключи left не больше ключей right
+    static TreapNode* merge(TreapNode* left, TreapNode* right) {
+        if (!left) return right;
+        if (!right) return left;
+        if (left->priority > right->priority) {
+            left->right = merge(left->right, right);
+            updateSize(left);
+            return left;
+        }
+        right->left = merge(left, right->left);
+        updateSize(right);
+        return right;
+    }
+
+    // Построение за O(n) из отсортированных ключей стеком правой ветви
+    static TreapNode* buildSorted(const int* keys, size_t count, mt19937& rng) {
+        vector<TreapNode*> spine;
+        for (size_t i = 0; i < count; ++i) {
+            TreapNode* node = new TreapNode(keys[i], rng());
+            TreapNode* last = nullptr;
+            while (!spine.empty() && spine.back()->priority < node->priority) {
+                last = spine.back();
+                spine.pop_back();
+                updateSize(last);
+                if (!spine.empty()) spine.back()->right = last;
+            }
+            node->left = last;
+            if (!spine.empty()) spine.back()->right = node;
+            spine.push_back(node);
+        }
+        // Размеры оставшейся правой ветви снизу вверх
+        for (size_t i = spine.size(); i-- > 0; ) {
+            updateSize(spine[i]);
+        }
+        return spine.empty() ? nullptr : spine.front();
+    }
+
+    static void destroy(TreapNode* node) {
+        if (!node) return;
+        destroy(node->left);
+        destroy(node->right);
+        delete node;
+    }
+
+    static int maxDepth(TreapNode* node) {
+        if (!node) return 0;
+        return 1 + max(maxDepth(node->left), maxDepth(node->right));
+    }
+
+    static bool checkNode(TreapNode* node, long long lo, long long hi) {
+        if (!node) return true;
+        if (node->key < lo || node->key > hi) return false;
+        if (node->left && node->left->priority > node->priority) return false;
+        if (node->right && node->right->priority > node->priority) return false;
+        if (node->size != 1 + getSize(node->left) + getSize(node->right)) return false;
+        return checkNode(node->left, lo, node->key) && checkNode(node->right, node->key, hi);
+    }
+
+    Treap(TreapNode* root, uint32_t seed) : root(root), gen(seed) {}
+
+public:
+    Treap() : root(nullptr), gen(random_device{}()) {}
+
+    Treap(const Treap&) = delete;
+    Treap& operator=(const Treap&) = delete;
+
+    Treap(Treap&& other) noexcept : root(other.root), gen(other.gen) {
+        other.root = nullptr;
+    }
+
+    Treap& operator=(Treap&& other) noexcept {
+        if (this != &other) {
+            destroy(root);
+            root = other.root;
+            gen = other.gen;
+            other.root = nullptr;
+        }
+        return *this;
+    }
+
+    ~Treap() {
+        destroy(root);
+    }
+
+    // Вставка: спуск до места, где приоритет нового узла больше,
+    // и разделение оставшегося поддерева по ключу (без поворотов)
+    void insert(int key) {
+        TreapNode* node = new TreapNode(key, gen());
+        TreapNode** link = &root;
+        while (*link && (*link)->priority >= node->priority) {
+            ++(*link)->size;
+            link = key < (*link)->key ? &(*link)->left : &(*link)->right;
+        }
+        auto [left, right] = split(*link, key);
+        node->left = left;
+        node->right = right;
+        updateSize(node);
+        *link = node;
+    }
+
+    // Удаление одного вхождения key: узел заменяется слиянием его детей
+    void remove(int key) {
+        if (!contains(key)) return;
+        TreapNode** link = &root;
+        while ((*link)->key != key) {
+            --(*link)->size;
+            link = key < (*link)->key ? &(*link)->left : &(*link)->right;
+        }
+        TreapNode* node = *link;
+        *link = merge(node->left, node->right);
+        delete node;
+    }
+
+    bool contains(int key) const {
+        TreapNode* node = root;
+        while (node && node->key != key) {
+            node = key < node->key ? node->left : node->right;
+        }
+        return node != nullptr;
+    }
+
+    int size() const {
+        return getSize(root);
+    }
+
+    // Отделение ключей >= key в новое дерево, O(log n)
+    Treap split(int key) {
+        auto [left, right] = split(root, key);
+        root = left;
+        return Treap(right, gen());
+    }
+
+    // Присоединение дерева, все ключи которого не меньше ключей этого, O(log n)
+    void merge(Treap& other) {
+        if (&other == this || !other.root) return;
+        if (root) {
+            TreapNode* last = root;
+            while (last->right) last = last->right;
+            TreapNode* first = other.root;
+            while (first->left) first = first->left;
+            if (first->key < last->key) {
+                throw invalid_argument("Treap::merge requires all keys of other to follow this tree");
+            }
+        }
+        root = merge(root, other.root);
+        other.root = nullptr;
+    }
+
+    // Извлечение всех ключей из [lo, hi] в отдельное дерево, O(log n)
+    Treap extractRange(int lo, int hi) {
+        if (hi < lo) return Treap(nullptr, gen());
+        auto [left, rest] = split(root, lo);
+        TreapNode* middle;
+        TreapNode* right;
+        if (hi == INT_MAX) {
+            middle = rest;
+            right = nullptr;
+        } else {
+            tie(middle, right) = split(rest, hi + 1);
+        }
+        root = merge(left, right);
+        return Treap(middle, gen());
+    }
+
+    // Удаление всех ключей из [lo, hi]: перестройка O(log n), освобождение
+    // узлов пропорционально их числу; возвращает количество удалённых
+    int eraseRange(int lo, int hi) {
+        Treap removed = extractRange(lo, hi);
+        return removed.size();
+    }
+
+    // Количество ключей в [lo, hi]
+    int countRange(int lo, int hi) const {
+        if (hi < lo) return 0;
+        int below = 0, notAbove = 0;
+        for (TreapNode* node = root; node; ) {
+            if (node->key < lo) {
+                below += getSize(node->left) + 1;
+                node = node->right;
+            } else {
+                node = node->left;
+            }
+        }
+        for (TreapNode* node = root; node; ) {
+            if (node->key <= hi) {
+                notAbove += getSize(node->left) + 1;
+                node = node->right;
+            } else {
+                node = node->left;
+            }
+        }
+        return notAbove - below;
+    }
+
+    // Построение из отсортированного массива (дерево должно быть пустым):
+    // части строятся параллельно за линейное время, затем сливаются по порядку
+    void buildFromSorted(const vector<int>& keys, unsigned threads = thread::hardware_concurrency()) {
+        if (!is_sorted(keys.begin(), keys.end())) {
+            throw invalid_argument("Treap::buildFromSorted requires sorted keys");
+        }
+        destroy(root);
+        root = nullptr;
+
+        size_t chunks = max<size_t>(1, min<size_t>(max(threads, 1u), keys.size() / PARALLEL_MIN_CHUNK));
+        size_t chunkSize = (keys.size() + chunks - 1) / chunks;
+        vector<TreapNode*> parts(chunks, nullptr);
+        vector<uint32_t> seeds(chunks);
+        for (auto& seed : seeds) seed = gen();
+
+        vector<thread> workers;
+        for (size_t c = 1; c < chunks; ++c) {
+            workers.emplace_back([&, c]() {
+                size_t begin = min(keys.size(), c * chunkSize);
+                size_t end = min(keys.size(), begin + chunkSize);
+                mt19937 rng(seeds[c]); // Свой генератор приоритетов у каждой части
+                parts[c] = buildSorted(keys.data() + begin, end - begin, rng);
+            });
+        }
+        mt19937 rng(seeds[0]);
+        parts[0] = buildSorted(keys.data(), min(keys.size(), chunkSize), rng);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        for (TreapNode* part : parts) {
+            root = merge(root, part);
+        }
+    }
+
+    int getMaxDepth() const {
+        return maxDepth(root);
+    }
+
+    // Проверка свойств BST, кучи и размеров поддеревьев
+    bool isValid() const {
+        return checkNode(root, LLONG_MIN, LLONG_MAX);
+    }
+
+    void clear() {
+        destroy(root);
+        root = nullptr;
+    }
+};
+
+// Функция для тестирования (аналогичная тестовой функции для RandomizedBST)
+void testTreap() {
+    const int REPETITIONS = 50;
+    const int OPERATIONS = 1000;
+
+    for (int i = 10; i <= 18; ++i) {
+        const size_t N = 1 << i; // 2^i
+
+        vector<double> maxDepths;
+        vector<double> insertTimes;
+        vector<double> deleteTimes;
+        vector<double> searchTimes;
+        vector<double> rangeEraseTimes;
+        vector<double> loopEraseTimes;
+        vector<double> bulkBuildTimes;
+        vector<double> insertBuildTimes;
+
+        cout << "Testing N = 2^" << i << " = " << N << "..." << endl;
+
+        for (int rep = 0; rep < REPETITIONS; ++rep) {
+            Treap tree;
+
+            // 1. Генерация N случайных значений
+            vector<int> elements(N);
+            for (auto& elem : elements) {
+                elem = rand() % (10 * N);
+            }
+
+            // 2. Заполнение дерева (с замером поэлементного построения)
+            auto start = high_resolution_clock::now();
+            for (int elem : elements) {
+                tree.insert(elem);
+            }
+            auto end = high_resolution_clock::now();
+            insertBuildTimes.push_back(duration_cast<microseconds>(end - start).count() / 1000.0);
+
+            // 3. Замер максимальной глубины
+            maxDepths.push_back(tree.getMaxDepth());
+
+            // 4. 1000 операций вставки и замер времени
+            start = high_resolution_clock::now();
+            for (int j = 0; j < OPERATIONS; ++j) {
+                int elem = rand() % (10 * N);
+                tree.insert(elem);
+            }
+            end = high_resolution_clock::now();
+            insertTimes.push_back(duration_cast<microseconds>(end - start).count() / 1000.0);
+
+            // 5. 1000 операций удаления и замер времени
+            start = high_resolution_clock::now();
+            for (int j = 0; j < OPERATIONS; ++j) {
+                int elem = rand() % 2 ? elements[rand() % elements.size()] : rand() % (10 * N);
+                tree.remove(elem);
+            }
+            end = high_resolution_clock::now();
+            deleteTimes.push_back(duration_cast<microseconds>(end - start).count() / 1000.0);
+
+            // 6. 1000 операций поиска и замер времени
+            start = high_resolution_clock::now();
+            for (int j = 0; j < OPERATIONS; ++j) {
+                int elem = rand() % 2 ? elements[rand() % elements.size()] : rand() % (10 * N);
+                tree.contains(elem);
+            }
+            end = high_resolution_clock::now();
+            searchTimes.push_back(duration_cast<microseconds>(end - start).count() / 1000.0);
+
+            // 7. Удаление диапазона из ~1% ключей: eraseRange против удаления по одному
+            int lo = rand() % (10 * N);
+            int hi = lo + static_cast<int>(N / 10);
+            vector<int> inRange;
+            for (int elem : elements) {
+                if (elem >= lo && elem <= hi) inRange.push_back(elem);
+            }
+            vector<int> sorted = elements;
+            sort(sorted.begin(), sorted.end());
+            Treap copy;
+            copy.buildFromSorted(sorted);
+            start = high_resolution_clock::now();
+            tree.eraseRange(lo, hi);
+            end = high_resolution_clock::now();
+            rangeEraseTimes.push_back(duration_cast<microseconds>(end - start).count() / 1000.0);
+
+            start = high_resolution_clock::now();
+            for (int elem : inRange) {
+                copy.remove(elem);
+            }
+            end = high_resolution_clock::now();
+            loopEraseTimes.push_back(duration_cast<microseconds>(end - start).count() / 1000.0);
+
+            // 8. Построение из отсортированного массива
+            Treap bulk;
+            start = high_resolution_clock::now();
+            bulk.buildFromSorted(sorted);
+            end = high_resolution_clock::now();
+            bulkBuildTimes.push_back(duration_cast<microseconds>(end - start).count() / 1000.0);
+
+            if (!tree.isValid() || !bulk.isValid() || bulk.size() != static_cast<int>(N)) {
+                cout << "  Treap check failed!" << endl;
+            }
+        }
+
+        // Вычисление статистики
+        auto average = [](const vector<double>& values) {
+            return accumulate(values.begin(), values.end(), 0.0) / values.size();
+        };
+
+        // Вывод результатов
+        cout << "Results for N = " << N << ":" << endl;
+        cout << "  Average max depth: " << average(maxDepths) << " (expected ~" << log2(N) << ")" << endl;
+        cout << "  Average insert time for " << OPERATIONS << " ops: " << average(insertTimes) << " ms" << endl;
+        cout << "  Average delete time for " << OPERATIONS << " ops: " << average(deleteTimes) << " ms" << endl;
+        cout << "  Average search time for " << OPERATIONS << " ops: " << average(searchTimes) << " ms" << endl;
+        cout << "  Range erase (~1% of keys): eraseRange " << average(rangeEraseTimes)
+             << " ms, remove per key " << average(loopEraseTimes) << " ms" << endl;
+        cout << "  Build: insert per key " << average(insertBuildTimes)
+             << " ms, buildFromSorted " << average(bulkBuildTimes) << " ms" << endl;
+        cout << endl;
+    }
+}
+
+int main() {
+    srand(time(nullptr)); // Инициализация генератора случайных чисел
+    testTreap();
+    return 0;
+}
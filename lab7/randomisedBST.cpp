@@ -7,6 +7,16 @@
 #include <climits>
 #include <fstream>
 #include <map>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <exception>
+#include <string>
+#include <ctime>
+#include <cstdint>
+#include <stdexcept>
+#include "benchRunner.h"
+#include "treeSnapshot.h"
 
 using namespace std;
 using namespace std::chrono;
@@ -24,6 +34,9 @@ struct Node {
 // Рандомизированное бинарное дерево поиска
 class RandomizedBST {
 private:
+    // Число одновременно выполняемых поисков в containsMany
+    static const int BATCH_GROUP = 16;
+    
     Node* root;
     mt19937 gen;
     
@@ -119,21 +132,78 @@ private:
         return 1 + max(maxDepth(node->left), maxDepth(node->right));
     }
     
-    // Сбор глубин всех веток
-    void collectBranchDepths(Node* node, int currentDepth, vector<int>& depths) const {
-        if (!node) return;
-        
-        if (!node->left && !node->right) {
-            depths.push_back(currentDepth + 1);
-            return;
+    // Количество ключей, меньших key (или не больших при inclusive)
+    int countLess(int key, bool inclusive) const {
+        int count = 0;
+        Node* node = root;
+        while (node) {
+            if (key < node->key || (!inclusive && key == node->key)) {
+                node = node->left;
+            } else {
+                count += getSize(node->left) + 1;
+                node = node->right;
+            }
         }
-        
-        collectBranchDepths(node->left, currentDepth + 1, depths);
-        collectBranchDepths(node->right, currentDepth + 1, depths);
+        return count;
     }
     
 public:
+    // Ленивый упорядоченный обход ключей из [lo, hi] с явным стеком O(высоты)
+    class RangeIterator {
+    private:
+        vector<Node*> path;
+        int hi;
+        
+        // Спуск по левым ветвям к первому ключу >= lo
+        void descend(Node* node, int lo) {
+            while (node) {
+                if (node->key < lo) {
+                    node = node->right;
+                } else {
+                    path.push_back(node);
+                    node = node->left;
+                }
+            }
+        }
+        
+        void dropIfPastEnd() {
+            if (!path.empty() && path.back()->key > hi) path.clear();
+        }
+        
+    public:
+        RangeIterator() : hi(0) {}
+        RangeIterator(Node* root, int lo, int hi) : hi(hi) {
+            descend(root, lo);
+            dropIfPastEnd();
+        }
+        
+        int operator*() const { return path.back()->key; }
+        
+        RangeIterator& operator++() {
+            Node* node = path.back();
+            path.pop_back();
+            for (node = node->right; node; node = node->left) {
+                path.push_back(node);
+            }
+            dropIfPastEnd();
+            return *this;
+        }
+        
+        bool operator==(const RangeIterator& other) const { return path.empty() && other.path.empty(); }
+        bool operator!=(const RangeIterator& other) const { return !(*this == other); }
+    };
+    
+    // Диапазон ключей [lo, hi] для цикла for
+    struct KeyRange {
+        Node* root;
+        int lo, hi;
+        
+        RangeIterator begin() const { return RangeIterator(root, lo, hi); }
+        RangeIterator end() const { return RangeIterator(); }
+    };
+    
     RandomizedBST() : root(nullptr), gen(random_device{}()) {}
+    explicit RandomizedBST(unsigned seed) : root(nullptr), gen(seed) {}
     
     // Вставка элемента
     void insert(int key) {
@@ -149,8 +219,10 @@ public:
             Node* node = root;
             Node* parent = nullptr;
             
+            // Размеры поддеревьев на пути увеличиваются сразу при спуске
             while (node) {
                 parent = node;
+                ++node->size;
                 if (key < node->key) {
                     node = node->left;
                 } else {
@@ -163,13 +235,6 @@ public:
             } else {
                 parent->right = new Node(key);
             }
-            
-            // Обновляем размеры на пути к корню
-            node = root;
-            while (node) {
-                updateSize(node);
-                node = key < node->key ? node->left : node->right;
-            }
         }
     }
     
@@ -183,16 +248,142 @@ public:
         return search(root, key) != nullptr;
     }
     
+    // Пакетный поиск: бит j в found (found[j / 64], бит j % 64) - есть ли keys[j].
+    // BATCH_GROUP поисков идут вперемешку как конечные автоматы (AMAC): каждый
+    // делает один шаг вниз и запрашивает prefetch следующего узла, а пока тот
+    // грузится из памяти, процессор выполняет шаги остальных поисков
+    void containsMany(const vector<int>& keys, vector<uint64_t>& found) const {
+        found.assign((keys.size() + 63) / 64, 0);
+        
+        struct Lookup {
+            const Node* node;
+            size_t index;
+        };
+        Lookup slots[BATCH_GROUP];
+        size_t next = 0;
+        int active = 0;
+        while (active < BATCH_GROUP && next < keys.size()) {
+            slots[active++] = {root, next++};
+        }
+        
+        while (active > 0) {
+            for (int s = 0; s < active; ) {
+                Lookup& lookup = slots[s];
+                const Node* node = lookup.node;
+                int key = keys[lookup.index];
+                
+                if (node && node->key != key) {
+                    node = key < node->key ? node->left : node->right;
+                    __builtin_prefetch(node);
+                    lookup.node = node;
+                    ++s;
+                    continue;
+                }
+                
+                // Поиск завершён: слот занимает следующий ключ или последний активный
+                if (node) {
+                    found[lookup.index / 64] |= uint64_t(1) << (lookup.index % 64);
+                }
+                if (next < keys.size()) {
+                    lookup = {root, next++};
+                    ++s;
+                } else {
+                    lookup = slots[--active];
+                }
+            }
+        }
+    }
+    
+    // Количество элементов
+    int size() const {
+        return getSize(root);
+    }
+    
+    // Порядковый номер: количество ключей, меньших key, O(log n)
+    int rank(int key) const {
+        return countLess(key, false);
+    }
+    
+    // k-й по возрастанию ключ (с нуля), O(log n)
+    int select(int k) const {
+        if (k < 0 || k >= getSize(root)) {
+            throw out_of_range("select index out of range");
+        }
+        Node* node = root;
+        while (true) {
+            int leftSize = getSize(node->left);
+            if (k < leftSize) {
+                node = node->left;
+            } else if (k == leftSize) {
+                return node->key;
+            } else {
+                k -= leftSize + 1;
+                node = node->right;
+            }
+        }
+    }
+    
+    // Количество ключей в [lo, hi], O(log n)
+    int countRange(int lo, int hi) const {
+        if (hi < lo) return 0;
+        return countLess(hi, true) - countLess(lo, false);
+    }
+    
+    // Ключи из [lo, hi] по возрастанию без материализации
+    KeyRange range(int lo, int hi) const {
+        return {root, lo, hi};
+    }
+    
     // Получение максимальной глубины
     int getMaxDepth() const {
         return maxDepth(root);
     }
     
-    // Получение глубин всех веток
-    vector<int> getAllBranchDepths() const {
-        vector<int> depths;
-        collectBranchDepths(root, 0, depths);
-        return depths;
+    // Добавление глубин всех веток в профиль. Обход без рекурсии: в стеке
+    // только отложенные правые поддеревья, по одному на уровень - O(высоты)
+    void profileDepths(DepthProfile& profile) const {
+        vector<pair<const Node*, int>> pending;
+        const Node* node = root;
+        int depth = 1;
+        while (node) {
+            bool hasLeft = node->left;
+            bool hasRight = node->right;
+            if (hasLeft || hasRight) {
+                if (hasLeft && hasRight) pending.push_back({node->right, depth + 1});
+                node = hasLeft ? node->left : node->right;
+                ++depth;
+                continue;
+            }
+    
+            profile.add(depth);
+            if (pending.empty()) break;
+            node = pending.back().first;
+            depth = pending.back().second;
+            pending.pop_back();
+        }
+    }
+    
+    // Образ дерева в прямом порядке обхода; aux - размер поддерева
+    vector<ImageNode> image() const {
+        return flattenPreorder<Node>(root, nullptr, [](const Node* node) {
+            return static_cast<uint32_t>(node->size);
+        });
+    }
+    
+    void saveSnapshot(const string& path) const {
+        writeSnapshot(path, TreeKind::RANDOMIZED, image());
+    }
+    
+    // Восстановление из образа за O(n) с той же формой и размерами поддеревьев
+    void restore(const TreeSnapshot& snapshot) {
+        snapshot.expect(TreeKind::RANDOMIZED);
+        vector<Node*> nodes = relinkImage<Node>(snapshot, nullptr, [](const ImageNode& image) {
+            Node* node = new Node(image.key);
+            node->size = static_cast<int>(image.aux);
+            return node;
+        });
+        clear();
+        root = nodes.empty() ? nullptr : nodes[0];
     }
     
     // Очистка дерева
@@ -204,28 +395,31 @@ public:
 };
 
 // Функция для тестирования
-void testRandomizedBST() {
+void testRandomizedBST(const RunOptions& options) {
     const int REPETITIONS = 50;
     const int OPERATIONS = 1000;
     
     for (int i = 10; i <= 18; ++i) {
         const size_t N = 1 << i; // 2^i
         
-        vector<double> maxDepths;
-        vector<double> insertTimes;
-        vector<double> deleteTimes;
-        vector<double> searchTimes;
-        vector<int> allBranchDepths;
+        vector<double> maxDepths(REPETITIONS);
+        vector<double> insertTimes(REPETITIONS);
+        vector<double> deleteTimes(REPETITIONS);
+        vector<double> searchTimes(REPETITIONS);
+        vector<double> batchSearchTimes(REPETITIONS);
+        vector<double> orderTimes(REPETITIONS);
+        DepthProfile branchProfile;
+        vector<DepthProfile> repProfiles(REPETITIONS);
         
         cout << "Testing N = 2^" << i << " = " << N << "..." << endl;
         
-        for (int rep = 0; rep < REPETITIONS; ++rep) {
-            RandomizedBST tree;
+        runRepetitions(REPETITIONS, i, options, [&](int rep, mt19937& rng) {
+            RandomizedBST tree(rng());
             
             // 1. Генерация N случайных значений
             vector<int> elements(N);
             for (auto& elem : elements) {
-                elem = rand() % (10 * N);
+                elem = rng() % (10 * N);
             }
             
             // 2. Заполнение дерева
@@ -234,40 +428,83 @@ void testRandomizedBST() {
             }
             
             // 3. Замер максимальной глубины
-            maxDepths.push_back(tree.getMaxDepth());
+            maxDepths[rep] = tree.getMaxDepth();
             
             // 4. 1000 операций вставки и замер времени
             auto start = high_resolution_clock::now();
             for (int j = 0; j < OPERATIONS; ++j) {
-                int elem = rand() % (10 * N);
+                int elem = rng() % (10 * N);
                 tree.insert(elem);
             }
             auto end = high_resolution_clock::now();
-            insertTimes.push_back(duration_cast<microseconds>(end - start).count() / 1000.0);
+            insertTimes[rep] = duration_cast<microseconds>(end - start).count() / 1000.0;
             
             // 5. 1000 операций удаления и замер времени
             start = high_resolution_clock::now();
             for (int j = 0; j < OPERATIONS; ++j) {
-                int elem = elements.empty() ? rand() % (10 * N) : 
-                          (rand() % 2 ? elements[rand() % elements.size()] : rand() % (10 * N));
+                int elem = elements.empty() ? rng() % (10 * N) : 
+                          (rng() % 2 ? elements[rng() % elements.size()] : rng() % (10 * N));
                 tree.remove(elem);
             }
             end = high_resolution_clock::now();
-            deleteTimes.push_back(duration_cast<microseconds>(end - start).count() / 1000.0);
+            deleteTimes[rep] = duration_cast<microseconds>(end - start).count() / 1000.0;
+            
+            // 6. 1000 операций поиска и замер времени. Запросы готовятся заранее,
+            // чтобы оба способа поиска шли по одним и тем же ключам; число
+            // найденных уходит в volatile, иначе компилятор выбросит поиск
+            vector<int> queries(OPERATIONS);
+            for (auto& elem : queries) {
+                elem = elements.empty() ? rng() % (10 * N) : 
+                      (rng() % 2 ? elements[rng() % elements.size()] : rng() % (10 * N));
+            }
+            volatile size_t hits = 0;
+            start = high_resolution_clock::now();
+            size_t sequentialHits = 0;
+            for (int elem : queries) {
+                sequentialHits += tree.contains(elem);
+            }
+            hits = sequentialHits;
+            end = high_resolution_clock::now();
+            searchTimes[rep] = duration_cast<microseconds>(end - start).count() / 1000.0;
             
-            // 6. 1000 операций поиска и замер времени
+            // 6.1. Те же поиски одним пакетом (containsMany)
+            vector<uint64_t> found;
             start = high_resolution_clock::now();
+            tree.containsMany(queries, found);
+            size_t batchHits = 0;
+            for (uint64_t word : found) {
+                batchHits += __builtin_popcountll(word);
+            }
+            hits = batchHits;
+            (void)hits;
+            end = high_resolution_clock::now();
+            batchSearchTimes[rep] = duration_cast<microseconds>(end - start).count() / 1000.0;
+            
+            for (size_t j = 0; j < queries.size(); ++j) {
+                if (((found[j / 64] >> (j % 64)) & 1) != static_cast<uint64_t>(tree.contains(queries[j]))) {
+                    throw logic_error("containsMany disagrees with contains");
+                }
+            }
+            
+            // 7. 1000 порядковых запросов (перцентили и подсчёт в диапазоне)
+            start = high_resolution_clock::now();
+            size_t counted = 0;
             for (int j = 0; j < OPERATIONS; ++j) {
-                int elem = elements.empty() ? rand() % (10 * N) : 
-                          (rand() % 2 ? elements[rand() % elements.size()] : rand() % (10 * N));
-                tree.contains(elem);
+                int percentile = tree.select(tree.size() * (j % 100) / 100);
+                int lo = rng() % (10 * N);
+                counted += tree.countRange(lo, lo + percentile % 1000);
             }
+            hits = counted;
             end = high_resolution_clock::now();
-            searchTimes.push_back(duration_cast<microseconds>(end - start).count() / 1000.0);
+            orderTimes[rep] = duration_cast<microseconds>(end - start).count() / 1000.0;
             
-            // 7. Сбор глубин всех веток
-            vector<int> depths = tree.getAllBranchDepths();
-            allBranchDepths.insert(allBranchDepths.end(), depths.begin(), depths.end());
+            // 8. Профиль глубин всех веток
+            tree.profileDepths(repProfiles[rep]);
+        });
+        
+        // Профили повторений сливаются по порядку номеров
+        for (const DepthProfile& profile : repProfiles) {
+            branchProfile.merge(profile);
         }
         
         // Вычисление статистики
@@ -275,10 +512,12 @@ void testRandomizedBST() {
         double avgInsertTime = accumulate(insertTimes.begin(), insertTimes.end(), 0.0) / insertTimes.size();
         double avgDeleteTime = accumulate(deleteTimes.begin(), deleteTimes.end(), 0.0) / deleteTimes.size();
         double avgSearchTime = accumulate(searchTimes.begin(), searchTimes.end(), 0.0) / searchTimes.size();
+        double avgBatchSearchTime = accumulate(batchSearchTimes.begin(), batchSearchTimes.end(), 0.0) / batchSearchTimes.size();
+        double avgOrderTime = accumulate(orderTimes.begin(), orderTimes.end(), 0.0) / orderTimes.size();
         
-        double avgBranchDepth = accumulate(allBranchDepths.begin(), allBranchDepths.end(), 0.0) / allBranchDepths.size();
-        int minBranchDepth = *min_element(allBranchDepths.begin(), allBranchDepths.end());
-        int maxBranchDepth = *max_element(allBranchDepths.begin(), allBranchDepths.end());
+        double avgBranchDepth = branchProfile.mean();
+        int minBranchDepth = branchProfile.minDepth();
+        int maxBranchDepth = branchProfile.maxDepth();
         
         // Вывод результатов
         cout << "Results for N = " << N << ":" << endl;
@@ -286,8 +525,10 @@ void testRandomizedBST() {
         cout << "  Average insert time for " << OPERATIONS << " ops: " << avgInsertTime << " ms" << endl;
         cout << "  Average delete time for " << OPERATIONS << " ops: " << avgDeleteTime << " ms" << endl;
         cout << "  Average search time for " << OPERATIONS << " ops: " << avgSearchTime << " ms" << endl;
+        cout << "  Average batched search time for " << OPERATIONS << " ops: " << avgBatchSearchTime << " ms" << endl;
+        cout << "  Average select+countRange time for " << OPERATIONS << " ops: " << avgOrderTime << " ms" << endl;
         cout << "  Branch depths - avg: " << avgBranchDepth << ", min: " << minBranchDepth 
-             << ", max: " << maxBranchDepth << endl;
+             << ", max: " << maxBranchDepth << ", stddev: " << branchProfile.stddev() << endl;
         cout << endl;
 
         // Для последней серии тестов (N=262144) сохраняем сырые данные
@@ -308,12 +549,13 @@ void testRandomizedBST() {
             }
             
             // 2. Гистограмма высот веток
-            map<int, int> branchDepthHist;
+            map<int, long long> branchDepthHist;
             int branchBinSize = 2; // Размер бина для группировки
             
-            for (int depth : allBranchDepths) {
+            for (int depth = branchProfile.minDepth(); depth <= branchProfile.maxDepth(); ++depth) {
+                if (!branchProfile.counts[depth]) continue;
                 int bin = depth / branchBinSize * branchBinSize;
-                branchDepthHist[bin]++;
+                branchDepthHist[bin] += branchProfile.counts[depth];
             }
             
             ofstream branchDepthFile("branch_depths.csv");
@@ -327,8 +569,52 @@ void testRandomizedBST() {
     }
 }
 
-int main() {
-    srand(time(nullptr)); // Инициализация генератора случайных чисел
-    testRandomizedBST();
+// Сохранение дерева в двоичный образ (treeSnapshot.h), открытие образа и
+// восстановление из него против построения теми же вставками
+void testSnapshots(const RunOptions& options) {
+    const int QUERIES = 1000000;
+    
+    ofstream csv("snapshot_results.csv");
+    csv << "N,Tree,Image_Bytes,Build_ms,Save_ms,Open_ms,Restore_ms,Built_Lookup_ns,Restored_Lookup_ns,Mapped_Lookup_ns\n";
+    
+    cout << endl << "Snapshots of randomized BSTs" << endl;
+    for (int i = 14; i <= 20; i += 2) {
+        const size_t N = 1 << i; // 2^i
+        seed_seq seq{options.seed, static_cast<unsigned>(i)};
+        mt19937 rng(seq);
+        
+        // Различные ключи в случайном порядке
+        vector<int> elements(N);
+        for (size_t j = 0; j < N; ++j) {
+            elements[j] = static_cast<int>(j * 10 + rng() % 10);
+        }
+        shuffle(elements.begin(), elements.end(), rng);
+        
+        // Половина запросов - существующие ключи, половина - случайные
+        vector<int> queries(QUERIES);
+        for (int j = 0; j < QUERIES; ++j) {
+            queries[j] = j % 2 ? elements[rng() % N] : static_cast<int>(rng() % (10 * N));
+        }
+        
+        {
+            RandomizedBST original(rng()), restored(rng());
+            testSnapshot("Randomized", original, restored, elements, queries, csv);
+            original.clear();
+            restored.clear();
+        }
+    }
+    
+    cout << "Snapshot results saved to snapshot_results.csv" << endl;
+}
+
+int main(int argc, char** argv) {
+    try {
+        RunOptions options = parseOptions(argc, argv);
+        testRandomizedBST(options);
+        testSnapshots(options);
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
     return 0;
 }
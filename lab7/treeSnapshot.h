@@ -0,0 +1,304 @@
+/*
+14) Сохранение дерева в двоичный образ и восстановление из него через mmap.
+    Образ - массив узлов в прямом порядке обхода со ссылками-индексами,
+    поэтому по отображённому файлу можно искать без разбора, а восстановление
+    дерева на указателях занимает O(n) и сохраняет форму: ни поворотов,
+    ни перекрашиваний. Формат общий для avlTree.cpp, dop_RBTree. и
+    randomisedBST.cpp; там же image/saveSnapshot/restore у самих деревьев и
+    сравнение с построением дерева вставками (testSnapshots).
+ */
+
+#ifndef TREE_SNAPSHOT_H
+#define TREE_SNAPSHOT_H
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <stdexcept>
+#ifdef __unix__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+enum class TreeKind : uint32_t { AVL = 1, RED_BLACK = 2, RANDOMIZED = 3 };
+
+const uint32_t NO_NODE = UINT32_MAX;
+const char SNAPSHOT_MAGIC[4] = {'T', 'R', 'S', '1'};
+
+// Заголовок файла; за ним сразу count узлов, корень - узел 0
+struct SnapshotHeader {
+    char magic[4];
+    uint32_t kind;
+    uint32_t nodeBytes; // sizeof(ImageNode) записавшей программы
+    uint32_t count;
+};
+
+// Узел образа. Потомки всегда лежат дальше родителя (прямой порядок),
+// левый потомок - сразу за ним
+struct ImageNode {
+    int32_t key;
+    uint32_t left;
+    uint32_t right;
+    uint32_t aux; // Высота AVL-узла, цвет RB-узла или размер поддерева
+};
+
+// Раскладка дерева в массив в прямом порядке обхода без рекурсии.
+// nil - пустая ссылка дерева (nullptr или фиктивный лист)
+template <typename NodeT, typename AuxOf>
+std::vector<ImageNode> flattenPreorder(const NodeT* root, const NodeT* nil, AuxOf auxOf) {
+    struct Pending {
+        const NodeT* node;
+        uint32_t parent;
+        bool isRight;
+    };
+
+    std::vector<ImageNode> image;
+    std::vector<Pending> stack;
+    if (root != nil) stack.push_back({root, NO_NODE, false});
+    while (!stack.empty()) {
+        Pending top = stack.back();
+        stack.pop_back();
+
+        uint32_t index = static_cast<uint32_t>(image.size());
+        if (top.parent != NO_NODE) {
+            (top.isRight ? image[top.parent].right : image[top.parent].left) = index;
+        }
+        image.push_back({top.node->key, NO_NODE, NO_NODE, auxOf(top.node)});
+
+        // Правое поддерево кладётся первым, чтобы левое шло сразу за узлом
+        if (top.node->right != nil) stack.push_back({top.node->right, index, true});
+        if (top.node->left != nil) stack.push_back({top.node->left, index, false});
+    }
+    return image;
+}
+
+inline void writeSnapshot(const std::string& path, TreeKind kind, const std::vector<ImageNode>& image) {
+    SnapshotHeader header;
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.kind = static_cast<uint32_t>(kind);
+    header.nodeBytes = sizeof(ImageNode);
+    header.count = static_cast<uint32_t>(image.size());
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(image.data()), image.size() * sizeof(ImageNode));
+    if (!out) {
+        throw std::runtime_error("Cannot write snapshot " + path);
+    }
+}
+
+// Образ, отображённый в память только для чтения. При открытии проверяется
+// заголовок и то, что ссылки образуют одно дерево: каждая ведёт вперёд, а на
+// каждый узел, кроме корня, ссылаются ровно один раз. Порядок ключей не
+// проверяется.
+class TreeSnapshot {
+private:
+    const char* base;
+    size_t length;
+    std::vector<char> buffer; // Без mmap файл читается целиком
+    const ImageNode* nodes;
+    uint32_t count;
+    TreeKind kind;
+
+    void map(const std::string& path) {
+#ifdef __unix__
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open snapshot " + path);
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(SnapshotHeader))) {
+            close(fd);
+            throw std::runtime_error("Snapshot is truncated: " + path);
+        }
+        length = static_cast<size_t>(info.st_size);
+        void* mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapping == MAP_FAILED) {
+            throw std::runtime_error("Cannot map snapshot " + path);
+        }
+        base = static_cast<const char*>(mapping);
+#else
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            throw std::runtime_error("Cannot open snapshot " + path);
+        }
+        buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        length = buffer.size();
+        if (length < sizeof(SnapshotHeader)) {
+            throw std::runtime_error("Snapshot is truncated: " + path);
+        }
+        base = buffer.data();
+#endif
+    }
+
+    void unmap() {
+#ifdef __unix__
+        if (base) munmap(const_cast<char*>(base), length);
+#endif
+        base = nullptr;
+    }
+
+    // Ссылки только вперёд исключают циклы, а ровно одна ссылка на каждый
+    // узел, кроме корня, - лес из нескольких деревьев и общие поддеревья
+    void validate(const std::string& path) const {
+        std::vector<bool> referenced(count, false);
+        for (uint32_t i = 0; i < count; ++i) {
+            for (uint32_t child : {nodes[i].left, nodes[i].right}) {
+                if (child == NO_NODE) continue;
+                if (child <= i || child >= count || referenced[child]) {
+                    throw std::runtime_error("Snapshot links do not form a tree: " + path);
+                }
+                referenced[child] = true;
+            }
+        }
+        for (uint32_t i = 1; i < count; ++i) {
+            if (!referenced[i]) {
+                throw std::runtime_error("Snapshot has nodes unreachable from the root: " + path);
+            }
+        }
+    }
+
+public:
+    explicit TreeSnapshot(const std::string& path) : base(nullptr), length(0), nodes(nullptr), count(0) {
+        map(path);
+        try {
+            SnapshotHeader header;
+            memcpy(&header, base, sizeof(header));
+            if (memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 ||
+                header.nodeBytes != sizeof(ImageNode)) {
+                throw std::runtime_error("Not a tree snapshot: " + path);
+            }
+            if (length != sizeof(header) + static_cast<size_t>(header.count) * sizeof(ImageNode)) {
+                throw std::runtime_error("Snapshot size does not match its header: " + path);
+            }
+            kind = static_cast<TreeKind>(header.kind);
+            count = header.count;
+            nodes = reinterpret_cast<const ImageNode*>(base + sizeof(header));
+            validate(path);
+        } catch (...) {
+            unmap();
+            throw;
+        }
+    }
+
+    ~TreeSnapshot() { unmap(); }
+
+    TreeSnapshot(const TreeSnapshot&) = delete;
+    TreeSnapshot& operator=(const TreeSnapshot&) = delete;
+
+    void expect(TreeKind expected) const {
+        if (kind != expected) {
+            throw std::invalid_argument("Snapshot holds a different kind of tree");
+        }
+    }
+
+    const ImageNode* data() const { return nodes; }
+    uint32_t size() const { return count; }
+
+    // Поиск прямо по отображённому образу
+    bool contains(int key) const {
+        uint32_t index = count ? 0 : NO_NODE;
+        while (index != NO_NODE) {
+            const ImageNode& node = nodes[index];
+            if (node.key == key) return true;
+            index = key < node.key ? node.left : node.right;
+        }
+        return false;
+    }
+};
+
+// Узлы дерева на указателях в порядке образа (корень - первый) с уже
+// расставленными ссылками на потомков; makeNode копирует ключ и aux
+template <typename NodeT, typename MakeNode>
+std::vector<NodeT*> relinkImage(const TreeSnapshot& snapshot, NodeT* nil, MakeNode makeNode) {
+    const ImageNode* image = snapshot.data();
+    std::vector<NodeT*> nodes(snapshot.size());
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        nodes[i] = makeNode(image[i]);
+    }
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        nodes[i]->left = image[i].left == NO_NODE ? nil : nodes[image[i].left];
+        nodes[i]->right = image[i].right == NO_NODE ? nil : nodes[image[i].right];
+    }
+    return nodes;
+}
+
+// Время (нс на запрос) серии поисков по дереву или по образу
+template <typename Searchable>
+double measureSnapshotLookups(const Searchable& tree, const std::vector<int>& queries, size_t& found) {
+    auto start = std::chrono::high_resolution_clock::now();
+    size_t hits = 0;
+    for (int key : queries) {
+        hits += tree.contains(key);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    found = hits;
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() /
+           static_cast<double>(queries.size());
+}
+
+// Построение вставками, сохранение, открытие образа и восстановление в
+// пустое дерево restored. Восстановленное дерево обязано дать тот же образ,
+// что и исходное, а все три способа поиска - одинаковые ответы
+template <typename Tree>
+void testSnapshot(const std::string& name, Tree& original, Tree& restored, const std::vector<int>& elements,
+                  const std::vector<int>& queries, std::ofstream& csv) {
+    using std::chrono::high_resolution_clock;
+    auto measureMs = [](auto action) {
+        auto start = high_resolution_clock::now();
+        action();
+        auto end = high_resolution_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    };
+    const std::string path = "snapshot_" + name + ".bin";
+
+    double buildTime = measureMs([&]() {
+        for (int elem : elements) {
+            original.insert(elem);
+        }
+    });
+    double saveTime = measureMs([&]() { original.saveSnapshot(path); });
+
+    std::unique_ptr<TreeSnapshot> snapshot;
+    double openTime = measureMs([&]() { snapshot.reset(new TreeSnapshot(path)); });
+    double restoreTime = measureMs([&]() { restored.restore(*snapshot); });
+
+    std::vector<ImageNode> before = original.image();
+    std::vector<ImageNode> after = restored.image();
+    if (before.size() != after.size() ||
+        memcmp(before.data(), after.data(), before.size() * sizeof(ImageNode)) != 0) {
+        throw std::logic_error("Restored " + name + " tree has a different shape");
+    }
+
+    size_t originalFound, restoredFound, mappedFound;
+    double originalLookup = measureSnapshotLookups(original, queries, originalFound);
+    double restoredLookup = measureSnapshotLookups(restored, queries, restoredFound);
+    double mappedLookup = measureSnapshotLookups(*snapshot, queries, mappedFound);
+    if (restoredFound != originalFound || mappedFound != originalFound) {
+        throw std::logic_error("Snapshot of " + name + " tree disagrees with the original");
+    }
+
+    size_t imageBytes = sizeof(SnapshotHeader) + before.size() * sizeof(ImageNode);
+    snapshot.reset();
+    std::remove(path.c_str());
+
+    std::cout << "  " << name << ": build " << buildTime << " ms, save " << saveTime << " ms, open "
+              << openTime << " ms, restore " << restoreTime << " ms (startup speedup "
+              << buildTime / (openTime + restoreTime) << "x); lookups: built " << originalLookup
+              << " ns, restored " << restoredLookup << " ns, mapped " << mappedLookup << " ns" << std::endl;
+    csv << elements.size() << "," << name << "," << imageBytes << "," << buildTime << "," << saveTime << ","
+        << openTime << "," << restoreTime << "," << originalLookup << "," << restoredLookup << ","
+        << mappedLookup << "\n";
+}
+
+#endif